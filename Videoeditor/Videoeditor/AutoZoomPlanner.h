@@ -0,0 +1,127 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "ZoomConfig.h"
+#include "CursorData.h"
+
+// Zoom applied to one output frame
+struct ZoomState {
+    double scale = 1.0;
+    double targetX = 0.5;   // Normalized zoom target (0-1)
+    double targetY = 0.5;
+};
+
+// Offline camera path for an auto-zoom layer. It sees the whole cursor track,
+// so unlike a running average it has no lag and can move ahead of the cursor:
+//   1. hold: the target only moves once the cursor leaves a dead zone around
+//      it, so jitter and small corrections leave the camera still
+//   2. lookahead: the target leads the cursor by LOOKAHEAD_SECONDS
+//   3. zero-phase smoothing: a first-order low-pass run forwards, then
+//      backwards, which cancels its delay
+//   4. motion limits: camera speed and acceleration are clamped
+// Each step is one pass over the layer's frames, so planning is linear in the
+// length of the recording.
+class AutoZoomPlanner {
+private:
+    static constexpr double DEAD_ZONE = 0.04;           // Normalized cursor movement ignored while holding
+    static constexpr double LOOKAHEAD_SECONDS = 0.3;
+    static constexpr double MAX_SPEED = 4.0;            // Screens per second at followSpeed 1
+    static constexpr double ACCELERATION_RATIO = 4.0;   // Max acceleration is the max speed times this, per second
+    static constexpr double MAX_TIME_CONSTANT = 0.5;    // Seconds of smoothing at smoothing 1
+
+    static void hold(std::vector<double>& xs, std::vector<double>& ys) {
+        if (xs.empty()) return;
+        double heldX = xs[0], heldY = ys[0];
+        for (size_t i = 0; i < xs.size(); ++i) {
+            double dx = xs[i] - heldX, dy = ys[i] - heldY;
+            if (dx * dx + dy * dy > DEAD_ZONE * DEAD_ZONE) {
+                heldX = xs[i];
+                heldY = ys[i];
+            }
+            xs[i] = heldX;
+            ys[i] = heldY;
+        }
+    }
+
+    static void lookahead(std::vector<double>& values, size_t frames) {
+        if (values.empty() || frames == 0) return;
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = values[(std::min)(i + frames, values.size() - 1)];
+        }
+    }
+
+    static void lowPassZeroPhase(std::vector<double>& values, double alpha) {
+        if (values.empty()) return;
+        for (size_t i = 1; i < values.size(); ++i) {
+            values[i] = values[i - 1] + (values[i] - values[i - 1]) * alpha;
+        }
+        for (size_t i = values.size() - 1; i-- > 0;) {
+            values[i] = values[i + 1] + (values[i] - values[i + 1]) * alpha;
+        }
+    }
+
+    // Follows the values with bounded speed and acceleration, slowing down in
+    // time to stop at the target instead of overshooting it
+    static void limitMotion(std::vector<double>& values, double maxStep, double maxAcceleration) {
+        if (values.empty()) return;
+        double position = values[0];
+        double velocity = 0;
+        for (size_t i = 1; i < values.size(); ++i) {
+            double distance = values[i] - position;
+            double speed = (std::min)({std::abs(distance), maxStep,
+                                       std::sqrt(2.0 * maxAcceleration * std::abs(distance))});
+            double desired = distance < 0 ? -speed : speed;
+            velocity = std::clamp(desired, velocity - maxAcceleration, velocity + maxAcceleration);
+            position += velocity;
+            values[i] = position;
+        }
+    }
+
+public:
+    // Camera path for frames layer.startFrame..layer.endFrame (inclusive),
+    // before the layer's enter/exit transitions are applied
+    static std::vector<ZoomState> plan(const AutoZoomLayer& layer, const CursorData& cursorData, double fps) {
+        int count = (std::max)(0, layer.endFrame - layer.startFrame + 1);
+        std::vector<CursorPosition> cursor = cursorData.getPositionsForFrames(layer.startFrame, count);
+        std::vector<double> xs(count), ys(count);
+        for (int i = 0; i < count; ++i) {
+            xs[i] = cursor[i].x;
+            ys[i] = cursor[i].y;
+        }
+
+        hold(xs, ys);
+        size_t lead = static_cast<size_t>(std::lround(LOOKAHEAD_SECONDS * fps));
+        lookahead(xs, lead);
+        lookahead(ys, lead);
+
+        double timeConstant = std::clamp(layer.smoothing, 0.0, 1.0) * MAX_TIME_CONSTANT;
+        double alpha = timeConstant > 0 ? 1.0 - std::exp(-1.0 / (timeConstant * fps)) : 1.0;
+        lowPassZeroPhase(xs, alpha);
+        lowPassZeroPhase(ys, alpha);
+
+        double maxStep = std::clamp(layer.followSpeed, 0.01, 1.0) * MAX_SPEED / fps;
+        double maxAcceleration = maxStep * ACCELERATION_RATIO / fps;
+        limitMotion(xs, maxStep, maxAcceleration);
+        limitMotion(ys, maxStep, maxAcceleration);
+
+        // Zoom in further the closer the camera is to the centre
+        std::vector<double> scales(count);
+        for (int i = 0; i < count; ++i) {
+            double dx = xs[i] - 0.5;
+            double dy = ys[i] - 0.5;
+            double distanceFromCenter = std::sqrt(dx * dx + dy * dy);
+            scales[i] = std::clamp(layer.minScale + (layer.maxScale - layer.minScale) * (1.0 - distanceFromCenter),
+                                   layer.minScale, layer.maxScale);
+        }
+        lowPassZeroPhase(scales, alpha);
+
+        std::vector<ZoomState> states(count);
+        for (int i = 0; i < count; ++i) {
+            states[i].scale = scales[i];
+            states[i].targetX = std::clamp(xs[i], 0.0, 1.0);
+            states[i].targetY = std::clamp(ys[i], 0.0, 1.0);
+        }
+        return states;
+    }
+};
@@ -0,0 +1,264 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ZoomConfig.h"
+#include "FrameLayout.h"
+#include "Trace.h"
+
+// Everything of the output frame that sits behind the video: the background
+// fill (solid, gradient, image or the blurred recording) and the drop shadow
+// of the video card. Static fills are rendered once per layout at output
+// resolution; the compositor copies from it and blends the card's rounded
+// corners against it.
+class BackgroundLayer {
+private:
+    struct ShadowKey {
+        cv::Size card;
+        double radius;
+        int blurSteps;
+
+        bool operator==(const ShadowKey& other) const {
+            return card == other.card && radius == other.radius && blurSteps == other.blurSteps;
+        }
+    };
+
+    // Blurred card masks of recent geometries, most recently used last. A
+    // layout that animates revisits the same few sizes, and rounding the blur
+    // radius keeps the number of distinct masks small.
+    std::vector<std::pair<ShadowKey, cv::Mat>> shadowCache;
+    cv::Mat canvas;
+    std::string loadedImagePath;
+    cv::Mat loadedImage;
+
+    const size_t SHADOW_CACHE_SIZE = 8;
+    const double BLUR_STEP = 4.0;        // Blur radii are rounded to multiples of this
+    const int FRAME_BLUR_DOWNSCALE = 8;  // BlurredFrame is blurred at 1/8 resolution
+
+    // Centred part of an image with the aspect of target, so scaling it to
+    // target covers the canvas without distortion
+    static cv::Rect coverCrop(const cv::Size& image, const cv::Size& target) {
+        double scale = (std::max)(static_cast<double>(target.width) / image.width,
+                                  static_cast<double>(target.height) / image.height);
+        int width = (std::min)(image.width, (std::max)(1, static_cast<int>(std::lround(target.width / scale))));
+        int height = (std::min)(image.height, (std::max)(1, static_cast<int>(std::lround(target.height / scale))));
+        return cv::Rect((image.width - width) / 2, (image.height - height) / 2, width, height);
+    }
+
+    // Gradient position t in [0, 1] of each pixel, blended between the two colours
+    template <typename Position>
+    void fillGradient(const BackgroundSettings& settings, Position position) {
+        cv::Scalar from = toScalar(settings.color);
+        cv::Scalar to = toScalar(settings.gradientColor);
+        for (int y = 0; y < canvas.rows; ++y) {
+            uint8_t* row = canvas.ptr<uint8_t>(y);
+            for (int x = 0; x < canvas.cols; ++x) {
+                double t = std::clamp(position(x + 0.5, y + 0.5), 0.0, 1.0);
+                for (int c = 0; c < 3; ++c) {
+                    row[x * 3 + c] = cv::saturate_cast<uint8_t>(from[c] + (to[c] - from[c]) * t);
+                }
+            }
+        }
+    }
+
+    void fillLinearGradient(const BackgroundSettings& settings) {
+        double angle = settings.gradientAngle * CV_PI / 180.0;
+        double dx = std::cos(angle), dy = std::sin(angle);
+        double cx = canvas.cols / 2.0, cy = canvas.rows / 2.0;
+        // Half the canvas extent along the gradient direction, so the end
+        // colours land exactly on the corners
+        double extent = (std::max)(1e-6, std::abs(dx) * cx + std::abs(dy) * cy);
+        fillGradient(settings, [&](double x, double y) {
+            return 0.5 + ((x - cx) * dx + (y - cy) * dy) / (2 * extent);
+        });
+    }
+
+    void fillRadialGradient(const BackgroundSettings& settings) {
+        double cx = canvas.cols / 2.0, cy = canvas.rows / 2.0;
+        double extent = (std::max)(1e-6, std::sqrt(cx * cx + cy * cy));
+        fillGradient(settings, [&](double x, double y) {
+            return std::sqrt((x - cx) * (x - cx) + (y - cy) * (y - cy)) / extent;
+        });
+    }
+
+    bool fillImage(const BackgroundSettings& settings) {
+        if (settings.imagePath != loadedImagePath) {
+            loadedImagePath = settings.imagePath;
+            loadedImage = cv::imread(settings.imagePath, cv::IMREAD_COLOR);
+            if (loadedImage.empty()) {
+                std::cerr << "Warning: could not load background image " << settings.imagePath << std::endl;
+            }
+        }
+        if (loadedImage.empty()) return false;
+        cv::Rect crop = coverCrop(loadedImage.size(), canvas.size());
+        int interpolation = crop.width > canvas.cols ? cv::INTER_AREA : cv::INTER_LINEAR;
+        cv::resize(loadedImage(crop), canvas, canvas.size(), 0, 0, interpolation);
+        return true;
+    }
+
+    // Downsample, blur and upsample: the blur hides any detail a full-
+    // resolution pass would have kept, at 1/64 of the pixels
+    void fillBlurredFrame(const BackgroundSettings& settings, const cv::Mat& source) {
+        TRACE_SCOPE("blurredFrame");
+        cv::Rect crop = coverCrop(source.size(), canvas.size());
+        cv::Size small((std::max)(1, crop.width / FRAME_BLUR_DOWNSCALE),
+                       (std::max)(1, crop.height / FRAME_BLUR_DOWNSCALE));
+        cv::Mat reduced;
+        cv::resize(source(crop), reduced, small, 0, 0, cv::INTER_AREA);
+        double outputPerSmall = static_cast<double>(canvas.cols) / small.width;
+        double sigma = settings.frameBlur / 2.0 / outputPerSmall;
+        if (sigma > 0.3) {
+            cv::GaussianBlur(reduced, reduced, cv::Size(0, 0), sigma);
+        }
+        cv::resize(reduced, canvas, canvas.size(), 0, 0, cv::INTER_LINEAR);
+    }
+
+    // Shadow alpha (0-255) for a card of the given size, padded by the blur margin
+    const cv::Mat& shadowMask(const cv::Size& card, double radius, double blur, int& margin) {
+        int blurSteps = static_cast<int>(std::lround(blur / BLUR_STEP));
+        double sigma = blurSteps * BLUR_STEP / 2.0;
+        margin = static_cast<int>(std::ceil(3.0 * sigma));
+
+        ShadowKey key{card, radius, blurSteps};
+        for (size_t i = 0; i < shadowCache.size(); ++i) {
+            if (shadowCache[i].first == key) {
+                std::rotate(shadowCache.begin() + i, shadowCache.begin() + i + 1, shadowCache.end());
+                return shadowCache.back().second;
+            }
+        }
+
+        TRACE_SCOPE("shadowMask");
+        cv::Size padded(card.width + 2 * margin, card.height + 2 * margin);
+        cv::Mat mask;
+        if (sigma < 1.0) {
+            mask = cv::Mat(padded, CV_8UC1, cv::Scalar(0));
+            fillRoundedRect(mask, cv::Rect(margin, margin, card.width, card.height), radius);
+        } else {
+            // The shadow has no detail finer than its blur, so blur at reduced
+            // resolution and scale the result up
+            double s = sigma >= 8.0 ? 0.25 : 1.0;
+            cv::Size small((std::max)(1, static_cast<int>(std::lround(padded.width * s))),
+                           (std::max)(1, static_cast<int>(std::lround(padded.height * s))));
+            cv::Mat shape(small, CV_8UC1, cv::Scalar(0));
+            cv::Rect cardRect(static_cast<int>(std::lround(margin * s)), static_cast<int>(std::lround(margin * s)),
+                              (std::max)(1, static_cast<int>(std::lround(card.width * s))),
+                              (std::max)(1, static_cast<int>(std::lround(card.height * s))));
+            fillRoundedRect(shape, cardRect & cv::Rect(cv::Point(0, 0), small), radius * s);
+            cv::GaussianBlur(shape, shape, cv::Size(0, 0), sigma * s);
+            cv::resize(shape, mask, padded, 0, 0, cv::INTER_LINEAR);
+        }
+
+        if (shadowCache.size() >= SHADOW_CACHE_SIZE) {
+            shadowCache.erase(shadowCache.begin());
+        }
+        shadowCache.emplace_back(key, mask);
+        return shadowCache.back().second;
+    }
+
+    void drawShadow(const ShadowSettings& shadow, const FrameLayout& layout) {
+        int margin = 0;
+        const cv::Mat& mask = shadowMask(layout.videoRect.size(), layout.cornerRadius, shadow.blur, margin);
+        cv::Point origin(layout.videoRect.x + static_cast<int>(std::lround(shadow.offsetX)) - margin,
+                         layout.videoRect.y + static_cast<int>(std::lround(shadow.offsetY)) - margin);
+        cv::Rect region = cv::Rect(origin, mask.size()) & cv::Rect(cv::Point(0, 0), canvas.size());
+        if (region.empty()) return;
+
+        cv::Scalar color = toScalar(shadow.color);
+        int opacity = static_cast<int>(std::lround(255.0 * std::clamp(shadow.opacity, 0.0, 1.0)));
+        for (int y = 0; y < region.height; ++y) {
+            const uint8_t* alpha = mask.ptr<uint8_t>(region.y - origin.y + y) + (region.x - origin.x);
+            uint8_t* dst = canvas.ptr<uint8_t>(region.y + y) + region.x * 3;
+            for (int x = 0; x < region.width; ++x) {
+                int a = alpha[x] * opacity / 255;
+                for (int c = 0; c < 3; ++c) {
+                    dst[x * 3 + c] = static_cast<uint8_t>(
+                        (dst[x * 3 + c] * (255 - a) + static_cast<int>(color[c]) * a + 127) / 255);
+                }
+            }
+        }
+    }
+
+public:
+    // BGR colour of an ARGB value from the configuration
+    static cv::Scalar toScalar(uint32_t argb) {
+        return cv::Scalar(argb & 0xFF, (argb >> 8) & 0xFF, (argb >> 16) & 0xFF);
+    }
+
+    // Anti-aliased coverage (0-255) of the top-left corner of a rounded
+    // rectangle, ceil(radius) pixels square. Coverage comes from the distance
+    // of each pixel centre to the arc, exact to within a pixel along the edge;
+    // the other corners are mirror images.
+    static cv::Mat cornerTile(double radius) {
+        int size = static_cast<int>(std::ceil((std::max)(0.0, radius)));
+        cv::Mat tile(size, size, CV_8UC1);
+        for (int y = 0; y < size; ++y) {
+            uint8_t* row = tile.ptr<uint8_t>(y);
+            double dy = (std::max)(0.0, radius - (y + 0.5));
+            for (int x = 0; x < size; ++x) {
+                double dx = (std::max)(0.0, radius - (x + 0.5));
+                double coverage = radius - std::sqrt(dx * dx + dy * dy) + 0.5;
+                row[x] = cv::saturate_cast<uint8_t>(255.0 * (std::min)(1.0, (std::max)(0.0, coverage)));
+            }
+        }
+        return tile;
+    }
+
+    // Fills rect of a CV_8UC1 mask with an anti-aliased rounded rectangle
+    static void fillRoundedRect(cv::Mat& mask, const cv::Rect& rect, double radius) {
+        mask(rect).setTo(cv::Scalar(255));
+        radius = (std::min)(radius, (std::min)(rect.width, rect.height) / 2.0);
+        cv::Mat tile = cornerTile(radius);
+        if (tile.empty()) return;
+        int size = tile.cols;
+        cv::Mat flipped;
+        tile.copyTo(mask(cv::Rect(rect.x, rect.y, size, size)));
+        cv::flip(tile, flipped, 1);
+        flipped.copyTo(mask(cv::Rect(rect.x + rect.width - size, rect.y, size, size)));
+        cv::flip(tile, flipped, 0);
+        flipped.copyTo(mask(cv::Rect(rect.x, rect.y + rect.height - size, size, size)));
+        cv::flip(tile, flipped, -1);
+        flipped.copyTo(mask(cv::Rect(rect.x + rect.width - size, rect.y + rect.height - size, size, size)));
+    }
+
+    // True when the background follows the recording and needs refreshing
+    static bool isDynamic(const BackgroundSettings& settings) {
+        return settings.type == BackgroundSettings::Type::BlurredFrame;
+    }
+
+    // Renders the background for a layout; source is only read by the
+    // BlurredFrame type. The result stays valid until the next call.
+    const cv::Mat& render(const BackgroundSettings& settings, const FrameLayout& layout, const cv::Mat& source) {
+        TRACE_SCOPE("BackgroundLayer::render");
+        canvas.create(layout.canvasSize, CV_8UC3);
+        bool filled = true;
+        switch (settings.type) {
+        case BackgroundSettings::Type::LinearGradient:
+            fillLinearGradient(settings);
+            break;
+        case BackgroundSettings::Type::RadialGradient:
+            fillRadialGradient(settings);
+            break;
+        case BackgroundSettings::Type::Image:
+            filled = fillImage(settings);
+            break;
+        case BackgroundSettings::Type::BlurredFrame:
+            filled = !source.empty();
+            if (filled) fillBlurredFrame(settings, source);
+            break;
+        default:
+            filled = false;
+            break;
+        }
+        if (!filled) {
+            canvas.setTo(toScalar(settings.color));
+        }
+        if (settings.shadow.enabled && settings.shadow.opacity > 0) {
+            drawShadow(settings.shadow, layout);
+        }
+        return canvas;
+    }
+};
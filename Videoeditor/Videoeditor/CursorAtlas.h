@@ -0,0 +1,302 @@
+#pragma once
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A read-only view of a whole file, mapped into memory
+class MappedFile {
+private:
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+    const uint8_t* bytes = nullptr;
+    size_t length = 0;
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (bytes) UnmapViewOfFile(bytes);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (bytes) munmap(const_cast<uint8_t*>(bytes), length);
+        if (fd >= 0) ::close(fd);
+#endif
+    }
+
+    bool open(const std::string& path) {
+#ifdef _WIN32
+        file = CreateFileW(std::filesystem::path(path).wstring().c_str(), GENERIC_READ, FILE_SHARE_READ,
+                           nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) return false;
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return false;
+        bytes = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        length = static_cast<size_t>(size.QuadPart);
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) return false;
+        void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED) return false;
+        bytes = static_cast<const uint8_t*>(view);
+        length = static_cast<size_t>(info.st_size);
+#endif
+        return bytes != nullptr;
+    }
+
+    const uint8_t* data() const {
+        return bytes;
+    }
+
+    size_t size() const {
+        return length;
+    }
+};
+
+// Rasterized cursors packed into one premultiplied BGRA image, with an index
+// of where each cursor type sits and where its hotspot is. Saved as a
+// ".veatlas" file: a fixed header, the index, then the pixels, so opening one
+// is a single file map and the sprites are read straight from the mapping.
+//
+// The key identifies what the atlas was rasterized from (see
+// CursorOverlay::atlasKey); converted cursor packs are written with key 0.
+class CursorAtlas {
+public:
+    struct Entry {
+        int type;
+        cv::Rect rect;       // Area of the atlas image
+        cv::Point hotspot;   // From the cursor position to the rect's top-left
+    };
+
+private:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint64_t key;
+        int32_t height;      // Cursor height the atlas was rasterized at
+        int32_t hasTint;
+        uint32_t tintColor;
+        int32_t width;       // Atlas image size
+        int32_t rows;
+        int32_t count;       // Index entries that follow the header
+    };
+
+    struct FileEntry {
+        int32_t type;
+        int32_t x, y, width, height;
+        int32_t hotspotX, hotspotY;
+    };
+
+    std::shared_ptr<MappedFile> file;   // Shared so copies of an overlay share one mapping
+    cv::Mat image;                      // CV_8UC4 premultiplied, over the mapping or owned
+    std::vector<Entry> entries;
+    uint64_t atlasKey = 0;
+    int cursorHeight = 0;
+    bool tinted = false;
+    uint32_t tint = 0;
+
+public:
+    // Packs premultiplied BGRA cursors into one image in shelves of equal-ish
+    // height, tallest first. rects receives where each input ended up.
+    static cv::Mat pack(const std::vector<cv::Mat>& cursors, std::vector<cv::Rect>& rects) {
+        const int MAX_WIDTH = 1024;
+        std::vector<size_t> order(cursors.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return cursors[a].rows > cursors[b].rows; });
+
+        rects.assign(cursors.size(), cv::Rect());
+        int x = 0, y = 0, shelf = 0, width = 0;
+        for (size_t i : order) {
+            cv::Size size = cursors[i].size();
+            if (x > 0 && x + size.width > MAX_WIDTH) {
+                y += shelf;
+                x = 0;
+                shelf = 0;
+            }
+            rects[i] = cv::Rect(x, y, size.width, size.height);
+            x += size.width;
+            shelf = (std::max)(shelf, size.height);
+            width = (std::max)(width, x);
+        }
+
+        cv::Mat atlas = cv::Mat::zeros((std::max)(1, y + shelf), (std::max)(1, width), CV_8UC4);
+        for (size_t i = 0; i < cursors.size(); ++i) {
+            cursors[i].copyTo(atlas(rects[i]));
+        }
+        return atlas;
+    }
+
+    // Takes an atlas built in memory, e.g. when the cache cannot be written
+    void assign(const cv::Mat& packed, std::vector<Entry> index, uint64_t key, int height, bool hasTint, uint32_t tintColor) {
+        file.reset();
+        image = packed;
+        entries = std::move(index);
+        atlasKey = key;
+        cursorHeight = height;
+        tinted = hasTint;
+        tint = tintColor;
+    }
+
+    // Writes the atlas to path, through a temporary file of this writer's own
+    // so readers never see a partial one
+    bool save(const std::string& path, std::string& error) const {
+        FileHeader header{};
+        std::memcpy(header.magic, "VECA", 4);
+        header.version = FORMAT_VERSION;
+        header.key = atlasKey;
+        header.height = cursorHeight;
+        header.hasTint = tinted ? 1 : 0;
+        header.tintColor = tint;
+        header.width = image.cols;
+        header.rows = image.rows;
+        header.count = static_cast<int32_t>(entries.size());
+
+        std::error_code ec;
+        std::filesystem::path target(path);
+        if (target.has_parent_path()) {
+            std::filesystem::create_directories(target.parent_path(), ec);
+        }
+        // Unique per writer: other processes, or this process's render and
+        // preview workers, may be saving the same atlas at the same time
+#ifdef _WIN32
+        unsigned long processId = GetCurrentProcessId();
+#else
+        unsigned long processId = static_cast<unsigned long>(getpid());
+#endif
+        std::ostringstream suffix;
+        suffix << "." << processId << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+        std::filesystem::path temporary = target;
+        temporary += suffix.str();
+        {
+            std::ofstream out(temporary, std::ios::binary);
+            if (!out.is_open()) {
+                error = "Could not write cursor atlas: " + temporary.string();
+                return false;
+            }
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            for (const Entry& entry : entries) {
+                FileEntry record{entry.type, entry.rect.x, entry.rect.y, entry.rect.width, entry.rect.height,
+                                 entry.hotspot.x, entry.hotspot.y};
+                out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+            }
+            for (int row = 0; row < image.rows; ++row) {
+                out.write(reinterpret_cast<const char*>(image.ptr(row)), image.cols * 4);
+            }
+            if (!out) {
+                error = "Could not write cursor atlas: " + temporary.string();
+                return false;
+            }
+        }
+        std::filesystem::rename(temporary, target, ec);
+        if (ec) {
+            std::filesystem::remove(temporary, ec);
+            // Another process may have written (and mapped) the same atlas first
+            if (!std::filesystem::exists(target)) {
+                error = "Could not write cursor atlas: " + path;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Maps an atlas file. Nothing is copied: the image is a view of the mapping.
+    bool open(const std::string& path) {
+        auto mapped = std::make_shared<MappedFile>();
+        if (!mapped->open(path) || mapped->size() < sizeof(FileHeader)) return false;
+
+        FileHeader header;
+        std::memcpy(&header, mapped->data(), sizeof(header));
+        if (std::memcmp(header.magic, "VECA", 4) != 0 || header.version != FORMAT_VERSION ||
+            header.width <= 0 || header.rows <= 0 || header.count < 0) {
+            return false;
+        }
+        size_t pixelsOffset = sizeof(FileHeader) + header.count * sizeof(FileEntry);
+        if (mapped->size() < pixelsOffset + static_cast<size_t>(header.width) * header.rows * 4) return false;
+
+        std::vector<Entry> index;
+        cv::Rect bounds(0, 0, header.width, header.rows);
+        for (int i = 0; i < header.count; ++i) {
+            FileEntry record;
+            std::memcpy(&record, mapped->data() + sizeof(FileHeader) + i * sizeof(FileEntry), sizeof(record));
+            cv::Rect rect(record.x, record.y, record.width, record.height);
+            if ((rect & bounds) != rect || rect.empty()) return false;
+            index.push_back({record.type, rect, cv::Point(record.hotspotX, record.hotspotY)});
+        }
+
+        image = cv::Mat(header.rows, header.width, CV_8UC4, const_cast<uint8_t*>(mapped->data() + pixelsOffset));
+        file = std::move(mapped);
+        entries = std::move(index);
+        atlasKey = header.key;
+        cursorHeight = header.height;
+        tinted = header.hasTint != 0;
+        tint = header.tintColor;
+        return true;
+    }
+
+    void close() {
+        file.reset();
+        image.release();
+        entries.clear();
+        atlasKey = 0;
+        cursorHeight = 0;
+    }
+
+    bool isOpen() const {
+        return !image.empty();
+    }
+
+    // Index entry of a cursor type, or nullptr when the atlas does not have it
+    const Entry* find(int type) const {
+        for (const Entry& entry : entries) {
+            if (entry.type == type) return &entry;
+        }
+        return nullptr;
+    }
+
+    // Premultiplied BGRA of one cursor; a view of the atlas, not a copy
+    cv::Mat sprite(const Entry& entry) const {
+        return image(entry.rect);
+    }
+
+    const std::vector<Entry>& getEntries() const { return entries; }
+    uint64_t key() const { return atlasKey; }
+    int height() const { return cursorHeight; }
+    bool hasTint() const { return tinted; }
+    uint32_t tintColor() const { return tint; }
+};
@@ -2,6 +2,9 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <utility>
 #include <nlohmann/json.hpp>
 
 struct CursorPosition {
@@ -9,11 +12,13 @@ struct CursorPosition {
     double y;               // Normalized y coordinate (0-1)
     int64_t timestamp;      // Milliseconds since start
     int cursorType;         // Windows cursor type ID
+    int buttons = 0;        // Mouse buttons held: 1 left, 2 right, 4 middle
 };
 
 class CursorData {
 private:
     std::vector<CursorPosition> positions;
+    std::vector<CursorPosition> frameTable;   // Optional, one entry per output frame
     double videoDuration;   // Duration in milliseconds
     double fps;            // Video FPS for interpolation
 
@@ -32,13 +37,16 @@ public:
             file >> j;
 
             positions.clear();
+            frameTable.clear();
             const auto& posArray = j["positions"];
+            positions.reserve(posArray.size());
             for (const auto& pos : posArray) {
                 CursorPosition cursorPos;
                 cursorPos.x = pos["x"].get<double>();
                 cursorPos.y = pos["y"].get<double>();
                 cursorPos.timestamp = pos["timestamp"].get<int64_t>();
                 cursorPos.cursorType = pos["cursorType"].get<int>();
+                cursorPos.buttons = pos.value("buttons", 0);
                 positions.push_back(cursorPos);
             }
 
@@ -59,6 +67,9 @@ public:
     }
 
     CursorPosition getPositionAtFrame(int frameIndex) const {
+        if (frameIndex >= 0 && static_cast<size_t>(frameIndex) < frameTable.size()) {
+            return frameTable[frameIndex];
+        }
         if (positions.empty()) {
             return {0.5, 0.5, 0, 65539};  // Default center position with standard cursor
         }
@@ -90,10 +101,74 @@ public:
         result.y = prev.y + t * (next.y - prev.y);
         result.timestamp = static_cast<int64_t>(timestamp);
         result.cursorType = next.cursorType;  // Use the next cursor type
+        result.buttons = prev.buttons;
 
         return result;
     }
 
+    // Positions of count consecutive frames from firstFrame, the same values as
+    // getPositionAtFrame but walking the track once instead of searching per frame
+    std::vector<CursorPosition> getPositionsForFrames(int firstFrame, int count) const {
+        if (!frameTable.empty() && firstFrame >= 0 &&
+            static_cast<size_t>(firstFrame) + (std::max)(count, 0) <= frameTable.size()) {
+            return std::vector<CursorPosition>(frameTable.begin() + firstFrame, frameTable.begin() + firstFrame + count);
+        }
+        return sampleFrames(positions, fps, firstFrame, count);
+    }
+
+    // Linear interpolation of a track at count consecutive frames, in one walk
+    static std::vector<CursorPosition> sampleFrames(const std::vector<CursorPosition>& track, double fps,
+                                                    int firstFrame, int count) {
+        std::vector<CursorPosition> result;
+        result.reserve((std::max)(count, 0));
+        size_t next = 0;
+        for (int i = 0; i < count; ++i) {
+            if (track.empty()) {
+                result.push_back({0.5, 0.5, 0, 65539});
+                continue;
+            }
+            double timestamp = ((firstFrame + i) * 1000.0) / fps;
+            while (next < track.size() && track[next].timestamp < timestamp) {
+                ++next;
+            }
+            if (next == 0) {
+                result.push_back(track.front());
+            } else if (next == track.size()) {
+                result.push_back(track.back());
+            } else {
+                const CursorPosition& after = track[next];
+                const CursorPosition& before = track[next - 1];
+                double t = (timestamp - before.timestamp) / (after.timestamp - before.timestamp);
+                result.push_back({before.x + t * (after.x - before.x), before.y + t * (after.y - before.y),
+                                  static_cast<int64_t>(timestamp), after.cursorType, before.buttons});
+            }
+        }
+        return result;
+    }
+
+    // Precomputed position of each output frame (e.g. smoothed by
+    // CursorSmoother). Lookups inside the table read it directly; frames past
+    // its end fall back to interpolating the raw samples.
+    void setFrameTable(std::vector<CursorPosition> table) {
+        frameTable = std::move(table);
+    }
+
+    // Raw samples in timestamp order
+    const std::vector<CursorPosition>& getPositions() const {
+        return positions;
+    }
+
+    // Distinct cursor types the recording uses, in ascending order
+    std::vector<int> getCursorTypes() const {
+        std::vector<int> types;
+        for (const CursorPosition& pos : positions) {
+            types.push_back(pos.cursorType);
+        }
+        std::sort(types.begin(), types.end());
+        types.erase(std::unique(types.begin(), types.end()), types.end());
+        return types;
+    }
+
     bool hasData() const {
         return !positions.empty();
     }
@@ -0,0 +1,201 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "CursorData.h"
+#include "ZoomConfig.h"
+
+// Something worth zooming in on, found in the cursor track
+struct CursorEvent {
+    enum class Type {
+        Click,    // A mouse button went down
+        Dwell,    // The cursor rested in one place
+        Typing    // I-beam cursor held nearly still, i.e. text entry
+    };
+
+    Type type;
+    int64_t startTime;   // Milliseconds
+    int64_t endTime;
+    double x;            // Normalized position (0-1)
+    double y;
+};
+
+// Clicks, dwells and typing bursts of a cursor track in start order, found in
+// one pass over the samples. generateLayers() turns them into zoom layers so a
+// recording gets sensible zooms without any hand-authored layers.
+class CursorEventIndex {
+private:
+    static constexpr int IBEAM_CURSOR = 65541;
+    static constexpr double STILL_RADIUS = 0.015;   // Normalized movement still counted as resting
+    static constexpr int64_t DWELL_MS = 1000;       // Shortest rest reported as a dwell
+    static constexpr int64_t TYPING_MS = 600;       // Shortest I-beam rest reported as typing
+
+    // Zoom layer generation
+    static constexpr int64_t CLICK_LEAD_MS = 400;   // Zoom arrives slightly before the click
+    static constexpr int64_t CLICK_TAIL_MS = 1200;
+    static constexpr int64_t TYPING_TAIL_MS = 800;
+    static constexpr int64_t MERGE_GAP_MS = 1500;   // Closer events share one layer
+    static constexpr double FOLLOW_SPREAD = 0.15;   // Events further apart get an auto layer
+    static constexpr double CLICK_SCALE = 1.8;
+    static constexpr double TYPING_SCALE = 2.0;
+
+    std::vector<CursorEvent> events;
+
+    struct Segment {
+        int64_t startTime;
+        int64_t endTime;
+        double minX, minY, maxX, maxY;
+        double sumX = 0, sumY = 0;
+        int count = 0;
+        double scale = 0;
+    };
+
+    static int toFrame(int64_t time, double fps) {
+        return static_cast<int>(std::floor(time * fps / 1000.0));
+    }
+
+    // Whether any of the first `count` layers overlaps the frame range
+    template <typename Layer>
+    static bool overlaps(const std::vector<Layer>& layers, size_t count, int startFrame, int endFrame) {
+        for (size_t i = 0; i < count; ++i) {
+            if (startFrame <= layers[i].endFrame && endFrame >= layers[i].startFrame) return true;
+        }
+        return false;
+    }
+
+    static void addLayer(const Segment& segment, ZoomConfig& config, double fps, int frameCount,
+                         size_t manualCount, size_t autoCount) {
+        // Leave room for the zoom to settle between the transitions
+        double transition = config.defaults.transitionDuration;
+        int64_t minimumLength = static_cast<int64_t>((2 * transition + 0.5) * 1000);
+        int startFrame = (std::max)(0, toFrame(segment.startTime, fps));
+        int endFrame = (std::min)(frameCount - 1,
+                                  toFrame((std::max)(segment.endTime, segment.startTime + minimumLength), fps));
+        if (endFrame <= startFrame) return;
+
+        // Layers from the configuration win over generated ones
+        if (overlaps(config.manualLayers, manualCount, startFrame, endFrame) ||
+            overlaps(config.autoLayers, autoCount, startFrame, endFrame)) {
+            return;
+        }
+
+        if (segment.maxX - segment.minX > FOLLOW_SPREAD || segment.maxY - segment.minY > FOLLOW_SPREAD) {
+            AutoZoomLayer layer;
+            layer.startFrame = startFrame;
+            layer.endFrame = endFrame;
+            layer.minScale = config.defaults.minScale;
+            layer.maxScale = (std::min)(config.defaults.maxScale, segment.scale);
+            layer.followSpeed = config.defaults.followSpeed;
+            layer.smoothing = config.defaults.smoothing;
+            config.autoLayers.push_back(layer);
+        } else {
+            ManualZoomLayer layer;
+            layer.startFrame = startFrame;
+            layer.endFrame = endFrame;
+            layer.startScale = layer.endScale = (std::min)(config.defaults.maxScale, segment.scale);
+            layer.targetX = segment.sumX / segment.count;
+            layer.targetY = segment.sumY / segment.count;
+            config.manualLayers.push_back(layer);
+        }
+    }
+
+public:
+    void build(const CursorData& cursorData) {
+        events.clear();
+        const std::vector<CursorPosition>& positions = cursorData.getPositions();
+        if (positions.empty()) return;
+
+        // Clicks are found at their start and rests at their end, so each kind
+        // is collected in start order on its own and the two merged afterwards
+        std::vector<CursorEvent> clicks;
+        std::vector<CursorEvent> rests;
+
+        const CursorPosition* anchor = &positions[0];   // First sample of the current rest
+        const CursorPosition* last = anchor;
+        bool typing = anchor->cursorType == IBEAM_CURSOR;
+        int previousButtons = 0;
+
+        auto endRest = [&]() {
+            int64_t length = last->timestamp - anchor->timestamp;
+            if (typing && length >= TYPING_MS) {
+                rests.push_back({CursorEvent::Type::Typing, anchor->timestamp, last->timestamp, anchor->x, anchor->y});
+            } else if (!typing && length >= DWELL_MS) {
+                rests.push_back({CursorEvent::Type::Dwell, anchor->timestamp, last->timestamp, anchor->x, anchor->y});
+            }
+        };
+
+        for (const CursorPosition& pos : positions) {
+            if (pos.buttons & ~previousButtons) {
+                clicks.push_back({CursorEvent::Type::Click, pos.timestamp, pos.timestamp, pos.x, pos.y});
+            }
+            previousButtons = pos.buttons;
+
+            double dx = pos.x - anchor->x;
+            double dy = pos.y - anchor->y;
+            bool ibeam = pos.cursorType == IBEAM_CURSOR;
+            if (dx * dx + dy * dy > STILL_RADIUS * STILL_RADIUS || ibeam != typing) {
+                endRest();
+                anchor = &pos;
+                typing = ibeam;
+            }
+            last = &pos;
+        }
+        endRest();
+
+        events.resize(clicks.size() + rests.size());
+        std::merge(clicks.begin(), clicks.end(), rests.begin(), rests.end(), events.begin(),
+                   [](const CursorEvent& a, const CursorEvent& b) { return a.startTime < b.startTime; });
+    }
+
+    const std::vector<CursorEvent>& getEvents() const {
+        return events;
+    }
+
+    // Appends a zoom layer for each run of nearby events. A run that stays in
+    // one spot gets a fixed zoom on it; one that moves around gets an auto
+    // layer that follows the cursor. Layers already in the configuration are
+    // kept and generated layers that would overlap them are dropped.
+    void generateLayers(ZoomConfig& config, double fps, int frameCount) const {
+        size_t manualCount = config.manualLayers.size();
+        size_t autoCount = config.autoLayers.size();
+
+        Segment segment{};
+        for (const CursorEvent& event : events) {
+            int64_t start = event.startTime;
+            int64_t end = event.endTime;
+            double scale = CLICK_SCALE;
+            if (event.type == CursorEvent::Type::Click) {
+                start -= CLICK_LEAD_MS;
+                end += CLICK_TAIL_MS;
+            } else if (event.type == CursorEvent::Type::Typing) {
+                end += TYPING_TAIL_MS;
+                scale = TYPING_SCALE;
+            }
+
+            if (segment.count > 0 && start > segment.endTime + MERGE_GAP_MS) {
+                addLayer(segment, config, fps, frameCount, manualCount, autoCount);
+                segment = Segment{};
+            }
+            if (segment.count == 0) {
+                segment.startTime = start;
+                segment.endTime = end;
+                segment.minX = segment.maxX = event.x;
+                segment.minY = segment.maxY = event.y;
+            }
+            segment.startTime = (std::min)(segment.startTime, start);
+            segment.endTime = (std::max)(segment.endTime, end);
+            segment.minX = (std::min)(segment.minX, event.x);
+            segment.maxX = (std::max)(segment.maxX, event.x);
+            segment.minY = (std::min)(segment.minY, event.y);
+            segment.maxY = (std::max)(segment.maxY, event.y);
+            segment.sumX += event.x;
+            segment.sumY += event.y;
+            segment.scale = (std::max)(segment.scale, scale);
+            segment.count++;
+        }
+        if (segment.count > 0) {
+            addLayer(segment, config, fps, frameCount, manualCount, autoCount);
+        }
+    }
+};
@@ -2,28 +2,72 @@
 #include <opencv2/opencv.hpp>
 #include <string>
 #include <unordered_map>
+#include <map>
 #include <filesystem>
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <fstream>
+#include <future>
+#include <iomanip>
 #include <sstream>
+#include <vector>
+#include "CursorAtlas.h"
 #include "ZoomConfig.h"
+#include "Trace.h"
 
-// Define this in exactly one source file before including nanosvg headers
-#define NANOSVG_IMPLEMENTATION
-#define NANOSVGRAST_IMPLEMENTATION
+// The nanosvg implementation is compiled once in nanosvg_impl.cpp
 #include "nanosvg/nanosvg.h"
 #include "nanosvg/nanosvgrast.h"
 
 class CursorOverlay {
 private:
-    std::unordered_map<int, cv::Mat> cursors;      // Cursor images for each type
-    std::unordered_map<int, cv::Mat> alphas;       // Alpha channels for each type
-    std::unordered_map<int, cv::Size> sizes;       // Original sizes for each cursor type
+    // A cursor ready to blend: tinted, scaled, and premultiplied by its alpha
+    // and the opacity setting
+    struct Sprite {
+        cv::Mat premultiplied;   // CV_8UC4, BGR * alpha and alpha
+        cv::Mat color;           // CV_8UC3, the premultiplied BGR
+        cv::Mat inverseAlpha;    // CV_8UC3, 255 - alpha in every channel
+    };
+
+    // A cursor type pre-shifted by every sub-pixel phase, so positions between
+    // pixels pick a sprite instead of resampling one per frame
+    static constexpr int PHASES = 4;   // Sub-pixel steps per axis
+    struct SpriteSet {
+        std::vector<Sprite> phases;    // PHASES x PHASES, row-major by y phase; one pixel larger than the cursor
+        cv::Point offset;              // From the cursor position to the sprite's top-left
+    };
+
+    // Where one sprite lands in a frame
+    struct Placement {
+        cv::Rect rect;
+        const Sprite* sprite;
+    };
+
+    std::map<int, std::string> cursorFiles;   // Source image of each cursor type
     bool isLoaded;
-    const int TARGET_HEIGHT = 128;  // Increased base height for better scaling
+    static constexpr int TARGET_HEIGHT = 128;  // Cursor height at size 1.0
     CursorSettings settings;       // Current cursor settings
 
-    cv::Mat loadSvg(const std::string& path, int targetHeight) {
+    // Cursor types rasterized at one height. Normally a cached file keyed by
+    // the sources and settings that grows as types are used (see
+    // ensureAtlas); with packAtlas set it is a converted cursor pack given to
+    // loadCursors() and never rebuilt.
+    CursorAtlas atlas;
+    bool packAtlas = false;
+
+    // Sprites for the current settings, cut from the atlas on first use of
+    // each type (or up front by prepare()). An empty set marks a type the
+    // atlas does not have.
+    std::unordered_map<int, SpriteSet> sprites;
+    double spriteScale = 1.0;
+
+    // Motion blur
+    static constexpr double SHUTTER = 0.5;   // Fraction of the frame interval the blur covers
+    cv::Mat accumulator;                     // CV_16UC4 sum of the sub-frame samples
+    Sprite blurred;
+
+    static cv::Mat loadSvg(const std::string& path, int targetHeight) {
         NSVGimage* image = nsvgParseFromFile(path.c_str(), "px", 96.0f);
         if (!image) {
             std::cerr << "Error loading SVG file: " << path << std::endl;
@@ -35,7 +79,7 @@ private:
         int width = static_cast<int>(std::ceil(image->width * scale));
         int height = static_cast<int>(std::ceil(image->height * scale));
 
-        // Create rasterizer and allocate buffer
+        // Create rasterizer
         NSVGrasterizer* rast = nsvgCreateRasterizer();
         if (!rast) {
             std::cerr << "Could not create rasterizer for: " << path << std::endl;
@@ -43,40 +87,19 @@ private:
             return cv::Mat();
         }
 
-        // Allocate memory for image
-        unsigned char* buffer = new unsigned char[width * height * 4];
-        
-        // Rasterize with proper scale and offset
-        nsvgRasterize(rast, image, 0, 0, scale, buffer, width, height, width * 4);
-
-        // Create OpenCV Mat and copy data
+        // Rasterize straight into the OpenCV buffer
         cv::Mat result(height, width, CV_8UC4);
-        memcpy(result.data, buffer, width * height * 4);
+        nsvgRasterize(rast, image, 0, 0, scale, result.data, width, height, static_cast<int>(result.step));
 
         // Clean up
-        delete[] buffer;
         nsvgDeleteRasterizer(rast);
         nsvgDelete(image);
 
         return result;
     }
 
-    cv::Mat normalizeSize(const cv::Mat& img) {
-        double scale = static_cast<double>(TARGET_HEIGHT) / img.rows;
-        cv::Mat resized;
-        // Use area interpolation for downscaling
-        if (scale < 1.0) {
-            cv::resize(img, resized, cv::Size(), scale, scale, cv::INTER_AREA);
-        } else {
-            // Use Lanczos for upscaling
-            cv::resize(img, resized, cv::Size(), scale, scale, cv::INTER_LANCZOS4);
-        }
-        return resized;
-    }
-
-    cv::Mat applyTint(const cv::Mat& cursor, uint32_t tintColor) {
+    static cv::Mat applyTint(const cv::Mat& cursor, uint32_t tintColor) {
         // Extract ARGB components
-        double alpha = ((tintColor >> 24) & 0xFF) / 255.0;
         double red = ((tintColor >> 16) & 0xFF) / 255.0;
         double green = ((tintColor >> 8) & 0xFF) / 255.0;
         double blue = (tintColor & 0xFF) / 255.0;
@@ -95,75 +118,380 @@ private:
         return tinted;
     }
 
-    bool loadCursor(const std::string& path, int cursorType) {
+    // BGRA image of a cursor at the given height. SVGs are rasterized directly
+    // at that height; bitmaps (and the PNG fallback for a broken SVG) are
+    // resized once.
+    static cv::Mat loadCursorImage(const std::string& path, int cursorType, int height) {
         cv::Mat img;
         // Get file extension
         std::string ext = std::filesystem::path(path).extension().string();
         std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-        
+
         if (ext == ".svg") {
-            // Try to load SVG first
-            img = loadSvg(path, TARGET_HEIGHT);
-            
-            // If SVG loading fails, try corresponding PNG
-            if (img.empty()) {
-                std::string pngPath = std::filesystem::path(path).parent_path().string() + "\\";
-                switch(cursorType) {
-                    case 32512: // IDC_ARROW (Standard arrow)
-                        pngPath += "cursor_normal.png";
-                        break;
-                    case 32515: // IDC_IBEAM (Text I-beam)
-                        pngPath += "cursor_text.png";
-                        break;
-                    case 32513: // IDC_HAND (Hand pointer)
-                        pngPath += "cursor_pointer.png";
-                        break;
-                    case 32644: // IDC_SIZEWE (Horizontal resize)
-                        pngPath += "cursor_resize_horizontal.png";
-                        break;
-                    case 32645: // IDC_SIZENS (Vertical resize)
-                        pngPath += "cursor_resize_vertical.png";
-                        break;
-                    default:
-                        pngPath += "cursor_normal.png";
-                }
-                img = cv::imread(pngPath, cv::IMREAD_UNCHANGED);
-                if (!img.empty()) {
-                    std::cout << "Successfully loaded fallback PNG: " << pngPath << std::endl;
-                }
+            img = loadSvg(path, height);
+            if (!img.empty()) {
+                return img;
+            }
+
+            // If SVG loading fails, try corresponding PNG (by Windows IDC_* or recorded type)
+            std::string pngName;
+            switch(cursorType) {
+                case 32512: // IDC_ARROW (Standard arrow)
+                case 65539:
+                    pngName = "cursor_normal.png";
+                    break;
+                case 32515: // IDC_IBEAM (Text I-beam)
+                case 65541:
+                    pngName = "cursor_text.png";
+                    break;
+                case 32513: // IDC_HAND (Hand pointer)
+                case 65567:
+                    pngName = "cursor_pointer.png";
+                    break;
+                case 32644: // IDC_SIZEWE (Horizontal resize)
+                case 65569:
+                    pngName = "cursor_resize_horizontal.png";
+                    break;
+                case 32645: // IDC_SIZENS (Vertical resize)
+                case 65551:
+                    pngName = "cursor_resize_vertical.png";
+                    break;
+                default:
+                    pngName = "cursor_normal.png";
             }
+            std::string pngPath = (std::filesystem::path(path).parent_path() / pngName).string();
+            img = cv::imread(pngPath, cv::IMREAD_UNCHANGED);
         } else {
             img = cv::imread(path, cv::IMREAD_UNCHANGED);
         }
 
         if (img.empty() || img.channels() != 4) {
+            return cv::Mat();
+        }
+
+        TRACE_SCOPE("cv::resize cursor");
+        double scale = static_cast<double>(height) / img.rows;
+        // Area interpolation for downscaling, Lanczos for upscaling
+        int interpolation = scale < 1.0 ? cv::INTER_AREA : cv::INTER_LANCZOS4;
+        cv::Mat resized;
+        cv::resize(img, resized, cv::Size(), scale, scale, interpolation);
+        return resized;
+    }
+
+    // Fills the blend planes of a sprite from its premultiplied BGRA
+    static void finishSprite(Sprite& sprite) {
+        cv::Mat alpha;
+        cv::cvtColor(sprite.premultiplied, sprite.color, cv::COLOR_BGRA2BGR);
+        cv::extractChannel(sprite.premultiplied, alpha, 3);
+        cv::bitwise_not(alpha, alpha);
+        cv::cvtColor(alpha, sprite.inverseAlpha, cv::COLOR_GRAY2BGR);
+    }
+
+    // Cursor images shipped with the editor, by cursor type
+    static const std::map<int, std::string>& standardFiles() {
+        static const std::map<int, std::string> files = {
+            {65539, "default.svg"},             // Normal arrow cursor (0)
+            {65541, "textcursor.svg"},          // Text cursor / I-beam (1)
+            {65567, "handpointing.svg"},        // Hand pointer (2)
+            {65551, "resizenorthsouth.svg"},    // Vertical resize (4)
+            {65569, "resizeleftright.svg"}      // Horizontal resize (5)
+        };
+        return files;
+    }
+
+    // Cursor files in a directory. Returns whether every standard cursor is
+    // there. A cursor pack with its own file names (e.g. "cursor packs/Macos")
+    // has its first image used as the arrow.
+    static bool findCursorFiles(const std::filesystem::path& dir, std::map<int, std::string>& found) {
+        found.clear();
+        bool allFound = true;
+        for (const auto& [type, filename] : standardFiles()) {
+            std::filesystem::path path = dir / filename;
+            if (std::filesystem::exists(path)) {
+                found[type] = path.string();
+            } else {
+                allFound = false;
+            }
+        }
+        if (!found.empty()) {
+            for (const auto& [type, filename] : standardFiles()) {
+                if (!found.count(type)) {
+                    std::cerr << "Failed to load cursor: " << (dir / filename).string() << std::endl;
+                }
+            }
+            return allFound;
+        }
+
+        std::vector<std::filesystem::path> images;
+        std::error_code ec;
+        for (const auto& item : std::filesystem::directory_iterator(dir, ec)) {
+            std::string ext = item.path().extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+            if (ext == ".svg" || ext == ".png") {
+                images.push_back(item.path());
+            }
+        }
+        if (images.empty()) {
+            std::cerr << "No cursor images found in: " << dir.string() << std::endl;
             return false;
         }
+        std::sort(images.begin(), images.end());
+        found[65539] = images.front().string();
+        return true;
+    }
 
-        // Print original size for debugging
-        std::cout << "Original cursor size for type " << cursorType << ": " 
-                  << img.cols << "x" << img.rows << std::endl;
+    int cursorHeight(double scale) const {
+        // Final size combines base scale and settings scale, at least 16 pixels
+        return (std::max)(static_cast<int>(TARGET_HEIGHT * scale * settings.size), 16);
+    }
+
+    // FNV-1a over the source files, the cursor height and the tint: everything
+    // the atlas pixels depend on (opacity is applied when sprites are cut)
+    static uint64_t atlasKey(const std::map<int, std::string>& files, int height, const CursorSettings& cursorSettings) {
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](const void* data, size_t size) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash = (hash ^ bytes[i]) * 1099511628211ull;
+            }
+        };
+        for (const auto& [type, path] : files) {
+            mix(&type, sizeof(type));
+            std::ifstream file(path, std::ios::binary);
+            std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            mix(content.data(), content.size());
+        }
+        uint32_t tint = cursorSettings.hasTint ? cursorSettings.tintColor : 0;
+        mix(&height, sizeof(height));
+        mix(&cursorSettings.hasTint, sizeof(cursorSettings.hasTint));
+        mix(&tint, sizeof(tint));
+        return hash;
+    }
 
-        // Normalize size while maintaining aspect ratio
-        cv::Mat normalizedImg = normalizeSize(img);
-        
-        // Print normalized size for debugging
-        std::cout << "Normalized cursor size: " 
-                  << normalizedImg.cols << "x" << normalizedImg.rows << std::endl;
+    static std::string atlasCachePath(uint64_t key) {
+        std::error_code ec;
+        std::filesystem::path dir = std::filesystem::temp_directory_path(ec);
+        std::ostringstream name;
+        name << std::hex << std::setw(16) << std::setfill('0') << key << ".veatlas";
+        return (dir / "videoeditor-cursors" / name.str()).string();
+    }
+
+    // Premultiplied BGRA of one cursor at the given height, tinted as set
+    static cv::Mat rasterize(const std::string& path, int cursorType, int height, const CursorSettings& cursorSettings) {
+        TRACE_SCOPE("CursorOverlay::rasterize");
+        cv::Mat image = loadCursorImage(path, cursorType, height);
+        if (image.empty()) {
+            std::cerr << "Failed to load cursor: " << path << std::endl;
+            return cv::Mat();
+        }
 
         std::vector<cv::Mat> channels;
-        cv::split(normalizedImg, channels);
-        
-        std::vector<cv::Mat> bgr = { channels[0], channels[1], channels[2] };
+        cv::split(image, channels);
         cv::Mat cursor;
-        cv::merge(bgr, cursor);
-        
-        cursors[cursorType] = cursor;
-        alphas[cursorType] = channels[3];
-        sizes[cursorType] = cursor.size();
+        cv::merge(std::vector<cv::Mat>{channels[0], channels[1], channels[2]}, cursor);
+
+        // Apply tint if enabled
+        if (cursorSettings.hasTint) {
+            cursor = applyTint(cursor, cursorSettings.tintColor);
+        }
+
+        cv::Mat alpha3;
+        cv::cvtColor(channels[3], alpha3, cv::COLOR_GRAY2BGR);
+        cv::Mat color;
+        cv::multiply(cursor, alpha3, color, 1.0 / 255.0);
+        std::vector<cv::Mat> premultiplied;
+        cv::split(color, premultiplied);
+        premultiplied.push_back(channels[3]);
+        cv::Mat result;
+        cv::merge(premultiplied, result);
+        return result;
+    }
+
+    // Rasterizes the given cursor files in parallel and packs them together
+    // with the cursors already in `existing` (which may be empty, or `built`)
+    static bool buildAtlas(const std::map<int, std::string>& files, int height, const CursorSettings& cursorSettings,
+                           uint64_t key, const CursorAtlas& existing, CursorAtlas& built) {
+        TRACE_SCOPE("CursorOverlay::buildAtlas");
+        std::vector<std::pair<int, std::future<cv::Mat>>> pending;
+        for (const auto& [type, path] : files) {
+            pending.emplace_back(type, std::async(std::launch::async, rasterize, path, type, height, cursorSettings));
+        }
+
+        std::vector<int> types;
+        std::vector<cv::Mat> images;
+        std::vector<cv::Point> hotspots;
+        for (const CursorAtlas::Entry& entry : existing.getEntries()) {
+            types.push_back(entry.type);
+            images.push_back(existing.sprite(entry));
+            hotspots.push_back(entry.hotspot);
+        }
+        size_t added = 0;
+        for (auto& [type, future] : pending) {
+            cv::Mat image = future.get();
+            if (image.empty()) continue;
+            types.push_back(type);
+            images.push_back(image);
+            // The sprite sits slightly up and left of the cursor position
+            hotspots.push_back(cv::Point(static_cast<int>(image.cols * 0.3), static_cast<int>(image.rows * 0.3)));
+            added++;
+        }
+        if (added == 0) return false;
+
+        std::vector<cv::Rect> rects;
+        cv::Mat packed = CursorAtlas::pack(images, rects);
+        std::vector<CursorAtlas::Entry> entries;
+        for (size_t i = 0; i < types.size(); ++i) {
+            entries.push_back({types[i], rects[i], hotspots[i]});
+        }
+        built.assign(packed, std::move(entries), key, height, cursorSettings.hasTint, cursorSettings.tintColor);
         return true;
     }
 
+    // Makes the atlas match the current settings at the given scale and hold
+    // the given cursor types. A matching atlas is kept, otherwise the cached
+    // one is mapped. Only types still missing are rasterized, and the grown
+    // atlas is written back to the cache, so a cold cache costs just the
+    // types a recording uses.
+    bool ensureAtlas(double scale, const std::vector<int>& types) {
+        if (packAtlas) {
+            return atlas.isOpen();
+        }
+        int height = cursorHeight(scale);
+        if (!atlas.isOpen() || atlas.height() != height || atlas.hasTint() != settings.hasTint ||
+            (settings.hasTint && atlas.tintColor() != settings.tintColor)) {
+            uint64_t key = atlasKey(cursorFiles, height, settings);
+            if (!atlas.open(atlasCachePath(key)) || atlas.key() != key) {
+                atlas.assign(cv::Mat(), {}, key, height, settings.hasTint, settings.tintColor);
+            }
+        }
+
+        std::map<int, std::string> missing;
+        for (int type : types) {
+            auto file = cursorFiles.find(type);
+            if (file != cursorFiles.end() && !atlas.find(type)) {
+                missing.insert(*file);
+            }
+        }
+        if (missing.empty()) {
+            return atlas.isOpen();
+        }
+        if (!buildAtlas(missing, height, settings, atlas.key(), atlas, atlas)) {
+            return atlas.isOpen();
+        }
+        std::string error;
+        if (!atlas.save(atlasCachePath(atlas.key()), error)) {
+            std::cerr << error << std::endl;
+        }
+        return true;
+    }
+
+    // Sprite of a cursor type at the current settings, or a fallback type
+    // when that one is not available
+    const SpriteSet* findSprite(int cursorType, double scale) {
+        if (scale != spriteScale) {
+            sprites.clear();
+            spriteScale = scale;
+        }
+        if (!isLoaded) {
+            return nullptr;
+        }
+        // Fall back to the text cursor, then the arrow (all a pack may have)
+        for (int type : {cursorType, 65541, 65539}) {
+            auto cached = sprites.find(type);
+            if (cached == sprites.end()) {
+                if (!ensureAtlas(scale, {type})) continue;
+                const CursorAtlas::Entry* entry = atlas.find(type);
+                cached = sprites.emplace(type, entry ? buildSprites(*entry, cursorHeight(scale)) : SpriteSet()).first;
+            }
+            if (!cached->second.phases.empty()) {
+                return &cached->second;
+            }
+        }
+        return nullptr;
+    }
+
+    // Cuts one cursor out of the atlas. Reads only the atlas and settings, so
+    // several types can be built in parallel.
+    SpriteSet buildSprites(const CursorAtlas::Entry& entry, int height) const {
+        TRACE_SCOPE("CursorOverlay::buildSprites");
+        // A view of the atlas; every step below writes a new image
+        cv::Mat premultiplied = atlas.sprite(entry);
+        cv::Point hotspot = entry.hotspot;
+
+        // Only a cursor pack can be at another height than the one asked for
+        if (atlas.height() > 0 && atlas.height() != height) {
+            double scale = static_cast<double>(height) / atlas.height();
+            int interpolation = scale < 1.0 ? cv::INTER_AREA : cv::INTER_LANCZOS4;
+            cv::Mat resized;
+            cv::resize(premultiplied, resized, cv::Size(), scale, scale, interpolation);
+            premultiplied = resized;
+            hotspot = cv::Point(static_cast<int>(hotspot.x * scale), static_cast<int>(hotspot.y * scale));
+        }
+
+        // Luminance is linear in the colour, so tinting premultiplied pixels
+        // gives the premultiplied tinted cursor
+        if (settings.hasTint && !atlas.hasTint()) {
+            std::vector<cv::Mat> channels;
+            cv::split(premultiplied, channels);
+            cv::Mat alpha = channels[3];
+            cv::Mat color;
+            cv::merge(std::vector<cv::Mat>{channels[0], channels[1], channels[2]}, color);
+            cv::split(applyTint(color, settings.tintColor), channels);
+            channels.push_back(alpha);
+            cv::Mat tinted;
+            cv::merge(channels, tinted);
+            premultiplied = tinted;
+        }
+
+        if (settings.opacity != 1.0) {
+            cv::Mat faded;
+            premultiplied.convertTo(faded, CV_8U, settings.opacity);
+            premultiplied = faded;
+        }
+
+        // Shifting premultiplied pixels keeps colour and coverage consistent at the edges
+        SpriteSet set;
+        set.phases.resize(PHASES * PHASES);
+        cv::Size shiftedSize(premultiplied.cols + 1, premultiplied.rows + 1);
+        for (int py = 0; py < PHASES; ++py) {
+            for (int px = 0; px < PHASES; ++px) {
+                cv::Matx23d shift(1, 0, static_cast<double>(px) / PHASES, 0, 1, static_cast<double>(py) / PHASES);
+                Sprite& sprite = set.phases[py * PHASES + px];
+                cv::warpAffine(premultiplied, sprite.premultiplied, shift, shiftedSize,
+                               cv::INTER_LINEAR, cv::BORDER_CONSTANT, cv::Scalar::all(0));
+                finishSprite(sprite);
+            }
+        }
+        set.offset = hotspot;
+        return set;
+    }
+
+    // Where a cursor at a (fractional) position lands, kept inside the frame,
+    // and the phase sprite that puts it there
+    static Placement placeSprite(const SpriteSet& set, const cv::Size& frameSize, cv::Point2d position) {
+        double left = position.x - set.offset.x;
+        double top = position.y - set.offset.y;
+        int x = static_cast<int>(std::floor(left));
+        int y = static_cast<int>(std::floor(top));
+        int phaseX = static_cast<int>(std::lround((left - x) * PHASES));
+        int phaseY = static_cast<int>(std::lround((top - y) * PHASES));
+        if (phaseX == PHASES) { x++; phaseX = 0; }
+        if (phaseY == PHASES) { y++; phaseY = 0; }
+
+        const Sprite& sprite = set.phases[phaseY * PHASES + phaseX];
+        cv::Size size = sprite.premultiplied.size();
+        x = std::clamp(x, 0, (std::max)(0, frameSize.width - size.width));
+        y = std::clamp(y, 0, (std::max)(0, frameSize.height - size.height));
+        return {cv::Rect(cv::Point(x, y), size) & cv::Rect(cv::Point(0, 0), frameSize), &sprite};
+    }
+
+    // dst = dst * (1 - alpha) + premultiplied colour, as two vectorised passes
+    static void blendSprite(cv::Mat roi, const Sprite& sprite) {
+        cv::Rect area(cv::Point(0, 0), roi.size());
+        cv::multiply(roi, sprite.inverseAlpha(area), roi, 1.0 / 255.0);
+        cv::add(roi, sprite.color(area), roi);
+    }
+
 public:
     CursorOverlay() : isLoaded(false) {
         settings.size = 1.0;
@@ -172,112 +500,131 @@ public:
     }
 
     void setSettings(const CursorSettings& newSettings) {
+        if (newSettings.size != settings.size || newSettings.opacity != settings.opacity ||
+            newSettings.hasTint != settings.hasTint || newSettings.tintColor != settings.tintColor) {
+            sprites.clear();
+        }
         settings = newSettings;
     }
 
+    // Finds the cursor images in cursorDir, which may also be a cursor pack
+    // directory or a converted pack (a .veatlas file from packCursors(), which
+    // is mapped and used as is). Nothing is rasterized yet: the atlas is
+    // mapped from the cache or built when a cursor is first needed, or by
+    // prepare().
     bool loadCursors(const std::string& cursorDir) {
-        std::filesystem::path dir(cursorDir);
-        if (!std::filesystem::exists(dir)) {
-            std::filesystem::create_directories(dir);
+        sprites.clear();
+        cursorFiles.clear();
+        atlas.close();
+        packAtlas = false;
+
+        std::error_code ec;
+        std::filesystem::path source(cursorDir);
+        if (std::filesystem::is_regular_file(source, ec)) {
+            packAtlas = atlas.open(source.string());
+            if (!packAtlas) {
+                std::cerr << "Failed to open cursor atlas: " << cursorDir << std::endl;
+            }
+            isLoaded = packAtlas;
+            return isLoaded;
         }
 
-        // Updated cursor type mappings to match JSON values
-        std::map<int, std::string> cursorFiles = {
-            {65539, "default.svg"},             // Normal arrow cursor (0)
-            {65541, "textcursor.svg"},          // Text cursor / I-beam (1)
-            {65567, "handpointing.svg"},        // Hand pointer (2)
-            {65551, "resizenorthsouth.svg"},    // Vertical resize (4)
-            {65569, "resizeleftright.svg"}      // Horizontal resize (5)
-        };
+        if (!std::filesystem::exists(source)) {
+            std::filesystem::create_directories(source);
+        }
+        isLoaded = findCursorFiles(source, cursorFiles);
+        return isLoaded;
+    }
 
-        std::cout << "\nLoading and normalizing cursors..." << std::endl;
-        bool allLoaded = true;
-        for (const auto& [type, filename] : cursorFiles) {
-            std::string path = (dir / filename).string();
-            if (!loadCursor(path, type)) {
-                std::cerr << "Failed to load cursor: " << path << std::endl;
-                allLoaded = false;
-            }
+    // Converts a cursor directory or pack into an atlas file at the base
+    // height, untinted, that loadCursors() can map directly
+    static bool packCursors(const std::string& packDir, const std::string& atlasPath, std::string& error) {
+        std::map<int, std::string> files;
+        findCursorFiles(packDir, files);
+        CursorAtlas packed;
+        if (files.empty() || !buildAtlas(files, TARGET_HEIGHT, CursorSettings(), 0, CursorAtlas(), packed)) {
+            error = "No cursors could be loaded from " + packDir;
+            return false;
         }
-        std::cout << "Cursor loading complete.\n" << std::endl;
+        return packed.save(atlasPath, error);
+    }
 
-        isLoaded = allLoaded;
-        return isLoaded;
+    // Cuts the sprites of the given cursor types (e.g. those a recording
+    // uses) in parallel, so the first frames of an export do not pay for them
+    void prepare(const std::vector<int>& cursorTypes) {
+        if (!isLoaded) return;
+        TRACE_SCOPE("CursorOverlay::prepare");
+        if (!ensureAtlas(spriteScale, cursorTypes)) return;
+        int height = cursorHeight(spriteScale);
+        std::vector<std::pair<int, std::future<SpriteSet>>> pending;
+        for (int type : cursorTypes) {
+            const CursorAtlas::Entry* entry = atlas.find(type);
+            if (!entry || sprites.count(type)) continue;
+            pending.emplace_back(type, std::async(std::launch::async, [this, entry, height]() {
+                return buildSprites(*entry, height);
+            }));
+        }
+        for (auto& [type, future] : pending) {
+            sprites[type] = future.get();
+        }
     }
 
-    void overlay(cv::Mat& frame, int x, int y, int cursorType = 65541, double scale = 1.0) {
-        if (!isLoaded || cursors.find(cursorType) == cursors.end()) {
-            cursorType = 65541;  // Fallback to normal arrow cursor
-            if (!isLoaded || cursors.find(cursorType) == cursors.end()) {
-                return;
-            }
+    // Blends the cursor into the frame and returns the region it touched,
+    // so callers can restore or recompose just that area on the next frame.
+    // Positions are in pixels and may fall between pixels.
+    cv::Rect overlay(cv::Mat& frame, double x, double y, int cursorType = 65541, double scale = 1.0) {
+        TRACE_SCOPE("CursorOverlay::overlay");
+        const SpriteSet* set = findSprite(cursorType, scale);
+        if (!set) {
+            return cv::Rect();
         }
 
-        // Get original cursor and alpha
-        cv::Mat cursor = cursors[cursorType].clone();
-        cv::Mat alpha = alphas[cursorType].clone();
-        const cv::Size& originalSize = sizes[cursorType];
+        Placement placement = placeSprite(*set, frame.size(), cv::Point2d(x, y));
+        blendSprite(frame(placement.rect), *placement.sprite);
+        return placement.rect;
+    }
 
-        // Apply tint if enabled
-        if (settings.hasTint) {
-            cursor = applyTint(cursor, settings.tintColor);
-        }
-
-        // Calculate final scale (combining base scale and settings scale)
-        double finalScale = scale * settings.size;
-        
-        // Calculate scaled size
-        int scaledWidth = static_cast<int>(originalSize.width * finalScale);
-        int scaledHeight = static_cast<int>(originalSize.height * finalScale);
-        
-        // Ensure minimum size
-        scaledWidth = std::max<int>(scaledWidth, 16);
-        scaledHeight = std::max<int>(scaledHeight, 16);
-
-        // Resize cursor and alpha if scale is not 1.0
-        if (std::abs(finalScale - 1.0) > 0.001) {
-            // Use area interpolation for downscaling
-            if (finalScale < 1.0) {
-                cv::resize(cursor, cursor, cv::Size(scaledWidth, scaledHeight), 0, 0, cv::INTER_AREA);
-                cv::resize(alpha, alpha, cv::Size(scaledWidth, scaledHeight), 0, 0, cv::INTER_AREA);
-            } else {
-                // Use Lanczos for upscaling
-                cv::resize(cursor, cursor, cv::Size(scaledWidth, scaledHeight), 0, 0, cv::INTER_LANCZOS4);
-                cv::resize(alpha, alpha, cv::Size(scaledWidth, scaledHeight), 0, 0, cv::INTER_LANCZOS4);
-            }
+    // Draws the cursor moving from one position to another during the frame.
+    // With motion blur enabled and the move faster than its threshold, the
+    // sprite is accumulated at several points along the move, over the last
+    // SHUTTER of the frame interval, and the average is blended once. The work
+    // is limited to the box the samples cover. Otherwise this is overlay(to).
+    cv::Rect overlayMotion(cv::Mat& frame, cv::Point2d from, cv::Point2d to, int cursorType = 65541) {
+        cv::Point2d move = to - from;
+        int samples = (std::max)(2, settings.motionBlurSamples);
+        if (!settings.motionBlur || std::hypot(move.x, move.y) < settings.motionBlurThreshold) {
+            return overlay(frame, to.x, to.y, cursorType);
         }
 
-        // Apply cursor offset (move slightly up and left)
-        x -= static_cast<int>(scaledWidth * 0.3);  // Move left by 20% of cursor width
-        y -= static_cast<int>(scaledHeight * 0.3); // Move up by 20% of cursor height
-
-        // Ensure coordinates are within frame
-        if (x < 0) x = 0;
-        if (y < 0) y = 0;
-        if (x + scaledWidth > frame.cols) x = frame.cols - scaledWidth;
-        if (y + scaledHeight > frame.rows) y = frame.rows - scaledHeight;
-
-        // Get ROI in the frame
-        cv::Mat roi = frame(cv::Rect(x, y, scaledWidth, scaledHeight));
-
-        // Overlay cursor using alpha blending with opacity
-        for (int i = 0; i < scaledHeight; i++) {
-            for (int j = 0; j < scaledWidth; j++) {
-                uchar a = alpha.at<uchar>(i, j);
-                if (a > 0) {
-                    cv::Vec3b& pixel = roi.at<cv::Vec3b>(i, j);
-                    cv::Vec3b cursor_pixel = cursor.at<cv::Vec3b>(i, j);
-                    
-                    float alpha_f = (a / 255.0f) * settings.opacity;
-                    pixel[0] = pixel[0] * (1 - alpha_f) + cursor_pixel[0] * alpha_f;
-                    pixel[1] = pixel[1] * (1 - alpha_f) + cursor_pixel[1] * alpha_f;
-                    pixel[2] = pixel[2] * (1 - alpha_f) + cursor_pixel[2] * alpha_f;
-                }
-            }
+        TRACE_SCOPE("CursorOverlay::overlayMotion");
+        const SpriteSet* set = findSprite(cursorType, 1.0);
+        if (!set) {
+            return cv::Rect();
+        }
+
+        std::vector<Placement> placements(samples);
+        cv::Rect bounds;
+        for (int i = 0; i < samples; ++i) {
+            double t = 1.0 - SHUTTER + SHUTTER * i / (samples - 1);
+            placements[i] = placeSprite(*set, frame.size(), from + move * t);
+            bounds = i == 0 ? placements[i].rect : (bounds | placements[i].rect);
         }
+
+        accumulator.create(bounds.size(), CV_16UC4);
+        accumulator.setTo(cv::Scalar::all(0));
+        for (const Placement& placement : placements) {
+            cv::Mat target = accumulator(placement.rect - bounds.tl());
+            cv::Mat source = placement.sprite->premultiplied(cv::Rect(cv::Point(0, 0), placement.rect.size()));
+            cv::add(target, source, target, cv::noArray(), CV_16U);
+        }
+        accumulator.convertTo(blurred.premultiplied, CV_8U, 1.0 / samples);
+        finishSprite(blurred);
+
+        blendSprite(frame(bounds), blurred);
+        return bounds;
     }
 
     bool isInitialized() const {
         return isLoaded;
     }
-}; 
\ No newline at end of file
+};
@@ -0,0 +1,126 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "CursorData.h"
+#include "ZoomConfig.h"
+
+// Smooths the recorded cursor path and evaluates it once per output frame.
+// The tracker samples roughly every 16 ms with timer jitter, so linear
+// interpolation shows both the jitter and the uneven spacing; the table built
+// here replaces it for every consumer (cursor overlay, zoom planner, idle
+// trimming) at the cost of one pass after loading.
+class CursorSmoother {
+private:
+    static constexpr double PI = 3.14159265358979323846;
+    static constexpr double DERIVATIVE_CUTOFF = 1.0;   // Hz, One-Euro speed estimate
+
+    static double lowPassAlpha(double cutoff, double dt) {
+        double tau = 1.0 / (2.0 * PI * cutoff);
+        return 1.0 / (1.0 + tau / dt);
+    }
+
+    // One-Euro filter (Casiez et al.) over the raw samples, using their real
+    // spacing so irregular timestamps do not read as speed changes
+    static std::vector<CursorPosition> oneEuro(const std::vector<CursorPosition>& samples,
+                                               double minCutoff, double beta) {
+        std::vector<CursorPosition> filtered = samples;
+        if (samples.empty()) return filtered;
+
+        double x = samples[0].x, y = samples[0].y;
+        double dx = 0, dy = 0;
+        for (size_t i = 1; i < samples.size(); ++i) {
+            double dt = (samples[i].timestamp - samples[i - 1].timestamp) / 1000.0;
+            if (dt <= 0) {
+                filtered[i].x = x;
+                filtered[i].y = y;
+                continue;
+            }
+            double derivativeAlpha = lowPassAlpha(DERIVATIVE_CUTOFF, dt);
+            dx += ((samples[i].x - x) / dt - dx) * derivativeAlpha;
+            dy += ((samples[i].y - y) / dt - dy) * derivativeAlpha;
+
+            double cutoff = minCutoff + beta * std::sqrt(dx * dx + dy * dy);
+            double alpha = lowPassAlpha(cutoff, dt);
+            x += (samples[i].x - x) * alpha;
+            y += (samples[i].y - y) * alpha;
+            filtered[i].x = x;
+            filtered[i].y = y;
+        }
+        return filtered;
+    }
+
+    // Centripetal Catmull-Rom (alpha 0.5) between p1 and p2 at fraction u of the
+    // segment; centripetal knots avoid the loops and cusps of the uniform form
+    static void catmullRom(const CursorPosition& p0, const CursorPosition& p1,
+                           const CursorPosition& p2, const CursorPosition& p3,
+                           double u, double& outX, double& outY) {
+        auto knot = [](const CursorPosition& a, const CursorPosition& b) {
+            double distance = std::sqrt((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y));
+            return (std::max)(std::sqrt(distance), 1e-4);
+        };
+        double t0 = 0;
+        double t1 = t0 + knot(p0, p1);
+        double t2 = t1 + knot(p1, p2);
+        double t3 = t2 + knot(p2, p3);
+        double t = t1 + (t2 - t1) * u;
+
+        // Barry-Goldman pyramid
+        auto lerp = [](double a, double b, double ta, double tb, double at) {
+            return (tb - at) / (tb - ta) * a + (at - ta) / (tb - ta) * b;
+        };
+        auto evaluate = [&](double v0, double v1, double v2, double v3) {
+            double a1 = lerp(v0, v1, t0, t1, t);
+            double a2 = lerp(v1, v2, t1, t2, t);
+            double a3 = lerp(v2, v3, t2, t3, t);
+            double b1 = lerp(a1, a2, t0, t2, t);
+            double b2 = lerp(a2, a3, t1, t3, t);
+            return lerp(b1, b2, t1, t2, t);
+        };
+        outX = evaluate(p0.x, p1.x, p2.x, p3.x);
+        outY = evaluate(p0.y, p1.y, p2.y, p3.y);
+    }
+
+    static void catmullRomFrames(const std::vector<CursorPosition>& samples, double fps,
+                                 std::vector<CursorPosition>& frames) {
+        size_t next = 0;
+        for (size_t i = 0; i < frames.size(); ++i) {
+            double timestamp = (i * 1000.0) / fps;
+            while (next < samples.size() && samples[next].timestamp < timestamp) {
+                ++next;
+            }
+            // Before the first or after the last sample the linear table already holds the endpoint
+            if (next == 0 || next == samples.size()) continue;
+
+            const CursorPosition& p1 = samples[next - 1];
+            const CursorPosition& p2 = samples[next];
+            const CursorPosition& p0 = next >= 2 ? samples[next - 2] : p1;
+            const CursorPosition& p3 = next + 1 < samples.size() ? samples[next + 1] : p2;
+            double u = (timestamp - p1.timestamp) / (p2.timestamp - p1.timestamp);
+            catmullRom(p0, p1, p2, p3, u, frames[i].x, frames[i].y);
+            frames[i].x = std::clamp(frames[i].x, 0.0, 1.0);
+            frames[i].y = std::clamp(frames[i].y, 0.0, 1.0);
+        }
+    }
+
+public:
+    // Position of each of the first frameCount frames, smoothed as configured.
+    // Cursor type and buttons are taken from the raw samples unchanged.
+    static std::vector<CursorPosition> buildFrameTable(const CursorData& cursorData, const CursorSettings& settings,
+                                                       int frameCount, double fps) {
+        const std::vector<CursorPosition>& samples = cursorData.getPositions();
+        switch (settings.smoothing) {
+        case CursorSettings::Smoothing::OneEuro: {
+            std::vector<CursorPosition> filtered = oneEuro(samples, settings.minCutoff, settings.beta);
+            return CursorData::sampleFrames(filtered, fps, 0, frameCount);
+        }
+        case CursorSettings::Smoothing::CatmullRom: {
+            std::vector<CursorPosition> frames = CursorData::sampleFrames(samples, fps, 0, frameCount);
+            catmullRomFrames(samples, fps, frames);
+            return frames;
+        }
+        default:
+            return CursorData::sampleFrames(samples, fps, 0, frameCount);
+        }
+    }
+};
@@ -0,0 +1,123 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// Easing curve of a zoom transition, mapping progress t in [0, 1] to [0, 1]
+// (a spring overshoots in between). Parsed from strings such as
+// "ease-in-out-quad", "cubic-bezier(0.25, 0.1, 0.25, 1)", "spring" or
+// "spring(0.4)" (damping ratio), and "expo".
+struct EasingCurve {
+    enum class Type {
+        EaseInOutQuad,
+        CubicBezier,
+        Spring,
+        Expo
+    };
+
+    Type type = Type::EaseInOutQuad;
+    double x1 = 0.25, y1 = 0.1, x2 = 0.25, y2 = 1.0;  // CubicBezier control points
+    double damping = 0.5;                              // Spring damping ratio (0-1)
+
+    static bool parse(const std::string& text, EasingCurve& curve) {
+        curve = EasingCurve();
+        if (text.empty() || text == "ease-in-out-quad") {
+            return true;
+        }
+        if (text == "expo") {
+            curve.type = Type::Expo;
+            return true;
+        }
+        if (text == "ease") {
+            curve.type = Type::CubicBezier;
+            return true;
+        }
+        if (text.rfind("cubic-bezier", 0) == 0) {
+            curve.type = Type::CubicBezier;
+            return std::sscanf(text.c_str(), "cubic-bezier(%lf ,%lf ,%lf ,%lf )",
+                               &curve.x1, &curve.y1, &curve.x2, &curve.y2) == 4 &&
+                   curve.x1 >= 0 && curve.x1 <= 1 && curve.x2 >= 0 && curve.x2 <= 1;
+        }
+        if (text.rfind("spring", 0) == 0) {
+            curve.type = Type::Spring;
+            if (text == "spring") return true;
+            return std::sscanf(text.c_str(), "spring(%lf )", &curve.damping) == 1 &&
+                   curve.damping > 0 && curve.damping <= 1;
+        }
+        return false;
+    }
+
+    double evaluate(double t) const {
+        t = std::clamp(t, 0.0, 1.0);
+        switch (type) {
+        case Type::CubicBezier:
+            return cubicBezier(t);
+        case Type::Spring:
+            return spring(t);
+        case Type::Expo:
+            if (t == 0.0 || t == 1.0) return t;
+            return t < 0.5 ? std::pow(2.0, 20 * t - 10) / 2 : (2 - std::pow(2.0, -20 * t + 10)) / 2;
+        default:
+            return t < 0.5 ? 2 * t * t : 1 - (-2 * t + 2) * (-2 * t + 2) / 2;
+        }
+    }
+
+private:
+    static double bezier(double a, double b, double s) {
+        // Endpoints at 0 and 1
+        double u = 1 - s;
+        return 3 * u * u * s * a + 3 * u * s * s * b + s * s * s;
+    }
+
+    // Solves x(s) = t by bisection (x is monotonic for control x in [0, 1]), returns y(s)
+    double cubicBezier(double t) const {
+        double lo = 0, hi = 1, s = t;
+        for (int i = 0; i < 40; ++i) {
+            s = (lo + hi) / 2;
+            if (bezier(x1, x2, s) < t) lo = s; else hi = s;
+        }
+        return bezier(y1, y2, s);
+    }
+
+    // Damped spring released from 0 towards 1, tuned to settle within 1% by t = 1
+    double spring(double t) const {
+        double omega = 4.6 / damping;
+        if (damping >= 1.0) {
+            return 1 - std::exp(-omega * t) * (1 + omega * t);
+        }
+        double omegaD = omega * std::sqrt(1 - damping * damping);
+        return 1 - std::exp(-damping * omega * t) *
+                   (std::cos(omegaD * t) + damping * omega / omegaD * std::sin(omegaD * t));
+    }
+};
+
+// An easing curve sampled once per frame of a transition, so evaluating a
+// frame of the transition is a single table read
+class EasingTable {
+private:
+    std::vector<double> values;
+
+public:
+    void build(const EasingCurve& curve, int frames) {
+        frames = (std::max)(frames, 1);
+        values.resize(frames + 1);
+        for (int i = 0; i <= frames; ++i) {
+            values[i] = curve.evaluate(static_cast<double>(i) / frames);
+        }
+        values.front() = 0.0;
+        values.back() = 1.0;
+    }
+
+    // Eased progress after `frame` frames of the transition
+    double at(long frame) const {
+        if (values.empty()) return 1.0;
+        return values[std::clamp<long>(frame, 0, static_cast<long>(values.size()) - 1)];
+    }
+
+    // Length of the transition in frames
+    int frames() const {
+        return static_cast<int>(values.size()) - 1;
+    }
+};
@@ -0,0 +1,382 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "VideoReader.h"
+#include "ExportProgress.h"
+#include "CursorData.h"
+#include "CursorOverlay.h"
+#include "CursorSmoother.h"
+#include "FrameCompositor.h"
+#include "FrameLayout.h"
+#include "IdleTrimmer.h"
+#include "ScreenActivity.h"
+#include "ZoomProcessor.h"
+#include "ZoomPlan.h"
+#include "CursorEvents.h"
+#include "ZoomConfig.h"
+#include "ZoomConfigLoader.h"
+
+// Input files of one export or preview request
+struct ExportJob {
+    std::string inputPath;
+    std::string outputPath;
+    std::string cursorDataPath;
+    std::string zoomConfigPath;
+    std::string format;  // Output aspect, see FrameLayout::parseFormat
+
+    // True when both jobs read the same recording and settings
+    bool sameProject(const ExportJob& other) const {
+        return inputPath == other.inputPath &&
+               cursorDataPath == other.cursorDataPath &&
+               zoomConfigPath == other.zoomConfigPath &&
+               format == other.format;
+    }
+};
+
+// Everything loaded from a job's input files. The render server keeps the
+// last project open so repeated previews skip reopening and reparsing.
+class Project {
+private:
+    std::string lastError;
+
+public:
+    ExportJob job;
+    VideoReader reader;
+    CursorData cursorData;
+    ZoomConfig config;
+    ZoomPlan zoomPlan;
+    FrameLayout layout;
+    ActivityAnalyzer activity;  // Filled beside decode by exports with config.analyzeActivity
+    double fps = 30.0;
+    uint64_t generation = 0;    // Unique per open(), so state kept for a project notices a reopen
+
+
+    // randomAccess builds (or loads) the keyframe index and enables the frame
+    // cache; worth it for previews, pointless for a single sequential export
+    bool open(const ExportJob& newJob, bool randomAccess = false) {
+        static std::atomic<uint64_t> openCount{0};
+        generation = ++openCount;
+        job = newJob;
+
+        // Open the input video file
+        std::cout << "\nOpening video file..." << std::endl;
+        if (!reader.open(job.inputPath)) {
+            lastError = "Error opening video: " + reader.getLastError();
+            return false;
+        }
+        if (randomAccess && !reader.enableRandomAccess()) {
+            std::cerr << "Keyframe index unavailable, seeking without it" << std::endl;
+        }
+
+        // Get video properties
+        fps = reader.getFPS();
+        if (fps <= 0) fps = 30.0;  // Fallback to 30fps if unable to get actual FPS
+
+        // Load cursor data
+        cursorData.setVideoFPS(fps);
+        if (!cursorData.loadFromJson(job.cursorDataPath)) {
+            lastError = "Failed to load cursor data from " + job.cursorDataPath;
+            return false;
+        }
+
+        // Load zoom configuration
+        if (!ZoomConfigLoader::loadFromJson(job.zoomConfigPath, config, lastError)) {
+            return false;
+        }
+
+        // Evaluate the (smoothed) cursor path once per frame; every later lookup reads the table
+        cursorData.setFrameTable(CursorSmoother::buildFrameTable(cursorData, config.cursor,
+                                                                 reader.getTotalFrames(), fps));
+
+        // Output geometry is fixed for the whole export
+        double aspect = 0;
+        if (!FrameLayout::parseFormat(job.format, aspect, lastError)) {
+            return false;
+        }
+        layout = FrameLayout::compute(cv::Size(reader.getWidth(), reader.getHeight()), config.background, aspect);
+
+        if (config.generateLayers) {
+            CursorEventIndex events;
+            events.build(cursorData);
+            events.generateLayers(config, fps, reader.getTotalFrames());
+        }
+
+        // Resolve the zoom of every frame once so any frame can be rendered directly
+        zoomPlan.build(config, &cursorData, reader.getTotalFrames(), fps);
+        return true;
+    }
+
+    const std::string& getLastError() const {
+        return lastError;
+    }
+};
+
+// Runs the decode -> composite -> zoom -> encode loop for a project
+class ExportPipeline {
+private:
+    CursorOverlay cursor;  // Copy of the preloaded sprites (cv::Mat copies share pixel data)
+    std::string lastError;
+
+    // Kept across renderFrame() calls: scrubbing through a static part of a
+    // recording then only recomposes what differs from the previous preview
+    FrameCompositor frameCompositor;
+    uint64_t frameGeneration = 0;   // Project::generation the compositor is set up for
+
+    unsigned long progressInterval = 30;  // Frames between progress callbacks
+
+public:
+    using ProgressCallback = std::function<void(const ExportProgress& progress)>;
+
+    explicit ExportPipeline(const CursorOverlay& loadedCursor) : cursor(loadedCursor) {}
+
+    // Calls the progress callback every `frames` frames (and once at the end)
+    void setProgressInterval(unsigned long frames) {
+        progressInterval = (std::max)(1UL, frames);
+    }
+
+    // Exports the whole project. When cancelled is set the partial output is
+    // removed and false is returned with "Export cancelled" as the error.
+    bool run(Project& project, const std::string& outputPath,
+             const std::atomic<bool>* cancelled, const ProgressCallback& onProgress) {
+        VideoReader& reader = project.reader;
+
+        // Idle stretches are skipped by seeking, never decoded
+        std::vector<FrameRange> cuts;
+        if (project.config.trim.enabled) {
+            if (!IdleTrimmer::findCuts(reader, project.cursorData, project.config.trim, project.fps, cuts, lastError)) {
+                return false;
+            }
+            std::cout << "Trimming " << cuts.size() << " idle ranges" << std::endl;
+        }
+        size_t nextCut = 0;
+
+        if (!reader.seekFrame(0)) {
+            lastError = reader.getLastError();
+            return false;
+        }
+
+        ZoomProcessor processor;
+        processor.setPlan(&project.zoomPlan);
+
+        // Apply cursor settings from zoom config
+        cursor.setSettings(project.config.cursor);
+        cursor.prepare(project.cursorData.getCursorTypes());
+
+        // Get input video properties
+        int frameWidth = reader.getWidth();
+        int frameHeight = reader.getHeight();
+        int totalFrames = IdleTrimmer::remainingFrames(reader.getTotalFrames(), cuts);
+        cv::Size outputSize = project.layout.canvasSize;
+
+        // Create video writer
+        std::filesystem::path outputVideoPath = outputPath;
+        cv::VideoWriter writer;
+        int fourcc = cv::VideoWriter::fourcc('m', 'p', '4', 'v');  // MP4 codec
+        writer.open(outputVideoPath.string(), fourcc, project.fps, outputSize, true);
+
+        if (!writer.isOpened()) {
+            lastError = "Could not create output video file";
+            return false;
+        }
+
+        // Calculate optimal buffer size based on available memory
+        const size_t maxBufferMB = 512;  // Maximum 512MB buffer
+        const size_t frameSize = frameWidth * frameHeight * 3;  // 3 channels (BGR)
+        const size_t maxFramesInBuffer = (maxBufferMB * 1024 * 1024) / frameSize;
+        const size_t bufferSize = (std::min)(maxFramesInBuffer, static_cast<size_t>(30));  // Max 30 frames or memory limit
+
+        // Create frame buffer, with the source index of each frame
+        std::vector<cv::Mat> frameBuffer;
+        std::vector<int> frameIndices;
+        frameBuffer.reserve(bufferSize);
+        frameIndices.reserve(bufferSize);
+
+        FrameCompositor compositor;
+        compositor.setSettings(project.config.background, project.layout);
+        project.activity.reset();
+
+        unsigned long frameIndex = 0;   // Frames written
+        int sourceIndex = 0;            // Next frame to decode
+        bool finished = false;          // No source frames left after the buffered ones
+        cv::Mat frame;
+
+        ExportProgress progress;
+        progress.totalFrames = totalFrames;
+        progress.decodedCapacity = bufferSize;
+        StageTimings& stages = progress.stages;
+        auto startTime = std::chrono::steady_clock::now();
+        auto report = [&](size_t queued) {
+            if (!onProgress) return;
+            progress.framesDone = frameIndex;
+            progress.decodedQueued = queued;
+            progress.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            onProgress(progress);
+        };
+
+        std::cout << "\nProcessing video..." << std::endl;
+        std::cout << "Total frames to process: " << totalFrames << std::endl;
+        std::cout << "Using buffer size: " << bufferSize << " frames" << std::endl;
+
+        while (true) {
+            if (cancelled && cancelled->load()) {
+                writer.release();
+                std::error_code ignored;
+                std::filesystem::remove(outputVideoPath, ignored);
+                lastError = "Export cancelled";
+                return false;
+            }
+
+            frameBuffer.clear();
+            frameIndices.clear();
+
+            // Fill buffer with frames
+            {
+                StageTimer timer(stages.decode);
+                for (size_t i = 0; i < bufferSize; ++i) {
+                    if (nextCut < cuts.size() && sourceIndex >= cuts[nextCut].first) {
+                        // Skip every cut that starts at or before the resume frame,
+                        // so touching cuts are skipped with a single seek
+                        int resume = sourceIndex;
+                        while (nextCut < cuts.size() && resume >= cuts[nextCut].first) {
+                            resume = (std::max)(resume, cuts[nextCut++].last + 1);
+                        }
+                        // A failed seek must end the export: the reader is still at
+                        // the start of the cut, and reading on would encode it
+                        if (!reader.seekFrame(resume)) {
+                            finished = true;  // Cut runs to the end of the video
+                            break;
+                        }
+                        sourceIndex = resume;
+                    }
+                    if (!reader.readFrame(frame)) {
+                        finished = true;
+                        break;
+                    }
+                    frameBuffer.push_back(frame.clone());
+                    frameIndices.push_back(sourceIndex++);
+                    if (project.config.analyzeActivity) {
+                        TRACE_SCOPE("activity.analyze");
+                        project.activity.analyze(frameBuffer.back());
+                    }
+                }
+            }
+            Trace::counter("decodeQueue", static_cast<int64_t>(frameBuffer.size()));
+
+            if (frameBuffer.empty()) {
+                break;  // End of video
+            }
+
+            // Process and write frames in buffer. The compositor and zoom processor
+            // reuse their previous output, so each frame is written before the next
+            // one is processed.
+            for (size_t i = 0; i < frameBuffer.size(); i++) {
+                // Composite onto the background and overlay the cursor
+                CursorPosition pos = project.cursorData.getPositionAtFrame(frameIndices[i]);
+                CursorPosition previousPos = project.cursorData.getPositionAtFrame((std::max)(0, frameIndices[i] - 1));
+                double composeMs = 0;
+                const cv::Mat* composited;
+                {
+                    StageTimer timer(composeMs);
+                    composited = &compositor.compose(frameBuffer[i], cursor, pos, &previousPos);
+                }
+                stages.cursor += compositor.getCursorMs();
+                stages.composite += composeMs - compositor.getCursorMs();
+
+                // Apply zoom effect, re-warping only the regions the compositor touched
+                cv::Mat processedFrame;
+                {
+                    StageTimer timer(stages.zoom);
+                    processor.processFrame(*composited, processedFrame, frameIndices[i],
+                                           &compositor.getDirtyRects());
+                }
+                {
+                    StageTimer timer(stages.encode);
+                    TRACE_SCOPE("writer.write");
+                    writer.write(processedFrame);
+                }
+
+                frameIndex++;
+                if (frameIndex % progressInterval == 0) {
+                    report(frameBuffer.size() - i - 1);
+                }
+            }
+            if (finished) {
+                break;
+            }
+        }
+
+        if (frameIndex % progressInterval != 0) {
+            report(0);
+        }
+        writer.release();
+        return true;
+    }
+
+    // Renders a single output frame exactly as the export would produce it
+    bool renderFrame(Project& project, int frameIndex, cv::Mat& output) {
+        int frameCount = project.reader.getTotalFrames();
+        if (frameIndex < 0 || frameIndex >= frameCount) {
+            lastError = "Frame " + std::to_string(frameIndex) + " is outside 0.." + std::to_string(frameCount - 1);
+            return false;
+        }
+
+        cv::Mat frame;
+        if (!project.reader.readFrameAt(frameIndex, frame)) {
+            lastError = "Could not read frame " + std::to_string(frameIndex);
+            return false;
+        }
+
+        cursor.setSettings(project.config.cursor);
+        // A new Project can reuse the previous one's address, so compare generations
+        if (frameGeneration != project.generation) {
+            frameCompositor.setSettings(project.config.background, project.layout);
+            frameGeneration = project.generation;
+        }
+
+        CursorPosition pos = project.cursorData.getPositionAtFrame(frameIndex);
+        CursorPosition previousPos = project.cursorData.getPositionAtFrame((std::max)(0, frameIndex - 1));
+        const cv::Mat& composited = frameCompositor.compose(frame, cursor, pos, &previousPos);
+
+        ZoomProcessor processor;
+        processor.setPlan(&project.zoomPlan);
+        processor.processFrame(composited, output, frameIndex);
+        return true;
+    }
+
+    // Writes a rendered frame as PNG, or as raw BGRA bytes (row-major, no
+    // header) when the path ends in .bgra. PNG uses the fastest compression
+    // level since these files are read back immediately by the editor.
+    static bool saveFrame(const cv::Mat& frame, const std::string& path, std::string& error) {
+        std::string ext = std::filesystem::path(path).extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+        if (ext == ".bgra") {
+            cv::Mat bgra;
+            cv::cvtColor(frame, bgra, cv::COLOR_BGR2BGRA);
+            std::ofstream file(path, std::ios::binary);
+            if (!file.is_open()) {
+                error = "Could not write " + path;
+                return false;
+            }
+            file.write(reinterpret_cast<const char*>(bgra.data), bgra.total() * bgra.elemSize());
+            return static_cast<bool>(file);
+        }
+
+        if (!cv::imwrite(path, frame, {cv::IMWRITE_PNG_COMPRESSION, 1})) {
+            error = "Could not write " + path;
+            return false;
+        }
+        return true;
+    }
+
+    const std::string& getLastError() const {
+        return lastError;
+    }
+};
@@ -0,0 +1,90 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <nlohmann/json.hpp>
+
+// Wall-clock milliseconds spent in each export stage, summed over all frames
+struct StageTimings {
+    double decode = 0;     // readFrame + copy into the frame buffer
+    double composite = 0;  // Background, scaling and rounded corners
+    double cursor = 0;     // CursorOverlay::overlay
+    double zoom = 0;       // ZoomProcessor::processFrame
+    double encode = 0;     // VideoWriter::write
+
+    StageTimings operator-(const StageTimings& other) const {
+        StageTimings diff;
+        diff.decode = decode - other.decode;
+        diff.composite = composite - other.composite;
+        diff.cursor = cursor - other.cursor;
+        diff.zoom = zoom - other.zoom;
+        diff.encode = encode - other.encode;
+        return diff;
+    }
+};
+
+// Adds the lifetime of the scope to a stage counter
+class StageTimer {
+private:
+    std::chrono::steady_clock::time_point start;
+    double& total;
+
+public:
+    explicit StageTimer(double& stageTotal)
+        : start(std::chrono::steady_clock::now()), total(stageTotal) {}
+
+    ~StageTimer() {
+        total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+// Snapshot passed to the export progress callback
+struct ExportProgress {
+    unsigned long framesDone = 0;
+    int totalFrames = 0;
+    double elapsedSeconds = 0;
+    StageTimings stages;
+    size_t decodedQueued = 0;    // Frames decoded but not yet composited
+    size_t decodedCapacity = 0;  // Size of the decode buffer
+};
+
+// Turns successive progress snapshots into JSON lines. Rates and stage times
+// are reported both since the previous line and over the whole export, so a
+// stall shows up immediately instead of being averaged away.
+class ProgressJsonWriter {
+private:
+    ExportProgress previous;
+
+    static nlohmann::json stagesJson(const StageTimings& stages) {
+        return {
+            {"decode", stages.decode},
+            {"composite", stages.composite},
+            {"cursor", stages.cursor},
+            {"zoom", stages.zoom},
+            {"encode", stages.encode}
+        };
+    }
+
+public:
+    nlohmann::json next(const ExportProgress& progress) {
+        unsigned long frames = progress.framesDone - previous.framesDone;
+        double seconds = progress.elapsedSeconds - previous.elapsedSeconds;
+        double fps = seconds > 0 ? frames / seconds : 0;
+        double averageFps = progress.elapsedSeconds > 0 ? progress.framesDone / progress.elapsedSeconds : 0;
+        double remaining = (std::max)(0.0, progress.totalFrames - static_cast<double>(progress.framesDone));
+
+        nlohmann::json line = {
+            {"event", "progress"},
+            {"frames", progress.framesDone},
+            {"total", progress.totalFrames},
+            {"fps", fps},
+            {"averageFps", averageFps},
+            {"etaSeconds", averageFps > 0 ? nlohmann::json(remaining / averageFps) : nlohmann::json(nullptr)},
+            {"elapsedSeconds", progress.elapsedSeconds},
+            {"queues", {{"decoded", progress.decodedQueued}, {"decodedCapacity", progress.decodedCapacity}}},
+            {"stageMs", stagesJson(progress.stages - previous.stages)},
+            {"stageMsTotal", stagesJson(progress.stages)}
+        };
+        previous = progress;
+        return line;
+    }
+};
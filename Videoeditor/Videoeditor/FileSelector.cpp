@@ -1,4 +1,10 @@
 #include "FileSelector.h"
+#include <windows.h>
+#include <shobjidl.h>
+
+bool FileSelector::isAvailable() {
+    return true;
+}
 
 std::string FileSelector::wstring_to_string(const std::wstring& wstr) {
     if (wstr.empty()) return "";
@@ -1,8 +1,9 @@
 #pragma once
 #include <string>
-#include <windows.h>
-#include <shobjidl.h>
 
+// Native file picker used by the interactive (no arguments) mode. This is the
+// only UI dependency of the exporter: FileSelector.cpp implements it with the
+// Win32 COM dialog, FileSelectorHeadless.cpp with nothing, for headless builds.
 class FileSelector {
 public:
     enum class FileType {
@@ -17,6 +18,9 @@ public:
     // Main file dialog function that returns a regular string
     static std::string showFileDialog(FileType type = FileType::Any);
 
+    // False when this build has no file dialogs (headless builds)
+    static bool isAvailable();
+
 private:
     // Internal function that handles the Windows API calls
     static std::wstring showFileDialogW(FileType type = FileType::Any);
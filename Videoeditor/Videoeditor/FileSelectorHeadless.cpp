@@ -0,0 +1,20 @@
+#include "FileSelector.h"
+
+// Headless builds (render workers) have no desktop to show a dialog on:
+// every path has to come from the command line.
+
+bool FileSelector::isAvailable() {
+    return false;
+}
+
+std::string FileSelector::wstring_to_string(const std::wstring& wstr) {
+    return std::string(wstr.begin(), wstr.end());
+}
+
+std::string FileSelector::showFileDialog(FileType type) {
+    return wstring_to_string(showFileDialogW(type));
+}
+
+std::wstring FileSelector::showFileDialogW(FileType) {
+    return L"";
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+// Least-recently-used cache of decoded frames, bounded by memory rather than
+// frame count so 4K and 720p recordings get the same footprint.
+// Cached frames are shared, not copied: callers must treat them as read-only.
+class FrameCache {
+private:
+    typedef std::pair<int, cv::Mat> Entry;
+
+    std::list<Entry> entries;  // Most recently used first
+    std::unordered_map<int, std::list<Entry>::iterator> lookup;
+    size_t capacityBytes;
+    size_t usedBytes;
+
+    static size_t frameBytes(const cv::Mat& frame) {
+        return frame.total() * frame.elemSize();
+    }
+
+    void evict() {
+        while (usedBytes > capacityBytes && !entries.empty()) {
+            const Entry& oldest = entries.back();
+            usedBytes -= frameBytes(oldest.second);
+            lookup.erase(oldest.first);
+            entries.pop_back();
+        }
+    }
+
+public:
+    explicit FrameCache(size_t capacityMB = 256)
+        : capacityBytes(capacityMB * 1024 * 1024), usedBytes(0) {}
+
+    void setCapacity(size_t capacityMB) {
+        capacityBytes = capacityMB * 1024 * 1024;
+        evict();
+    }
+
+    bool get(int frameIndex, cv::Mat& frame) {
+        auto it = lookup.find(frameIndex);
+        if (it == lookup.end()) {
+            return false;
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        frame = it->second->second;
+        return true;
+    }
+
+    void put(int frameIndex, const cv::Mat& frame) {
+        auto it = lookup.find(frameIndex);
+        if (it != lookup.end()) {
+            usedBytes -= frameBytes(it->second->second);
+            entries.erase(it->second);
+            lookup.erase(it);
+        }
+        entries.emplace_front(frameIndex, frame);
+        lookup[frameIndex] = entries.begin();
+        usedBytes += frameBytes(frame);
+        evict();
+    }
+
+    void clear() {
+        entries.clear();
+        lookup.clear();
+        usedBytes = 0;
+    }
+};
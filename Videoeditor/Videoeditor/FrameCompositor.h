@@ -0,0 +1,285 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "ZoomConfig.h"
+#include "CursorData.h"
+#include "CursorOverlay.h"
+#include "ExportProgress.h"
+#include "BackgroundLayer.h"
+#include "FrameLayout.h"
+#include "Trace.h"
+
+// Places the source frame on the styled background, as laid out by a
+// FrameLayout, and draws the cursor.
+// The last composite is kept between frames, so when only the cursor moved
+// (or a small part of the screen changed) just those regions are recomposed.
+class FrameCompositor {
+private:
+    BackgroundSettings settings;
+    FrameLayout layout;
+    cv::Size frameSize;              // Source frame size
+    cv::Rect videoRect;              // Where the scaled video sits on the canvas
+    cv::Rect visibleRect;            // videoRect clipped to the canvas
+    BackgroundLayer backgroundLayer;
+    cv::Mat background;              // Fill and shadow behind the video, at canvas size
+    cv::Rect cornerTiles[4];         // Corner squares on the canvas
+    cv::Mat cornerCoverage[4];       // 0-255 coverage of each corner tile
+    cv::Mat baseCanvas;              // Background + video, without the cursor
+    cv::Mat composite;               // Last output frame (baseCanvas + cursor)
+    cv::Mat previousSource;
+    cv::Rect previousCursorRect;
+    bool hasPrevious;
+    int framesSinceBackground;       // Frames composed since a dynamic background was rendered
+    bool backgroundStale;            // The source changed since then
+    std::vector<cv::Rect> dirtyRects;  // Canvas regions changed by the last compose()
+    double cursorMs;                 // Time the last compose() spent drawing the cursor
+
+    const int DIFF_TILE = 64;        // Tile size for the source frame diff
+    const int LANCZOS_RADIUS = 4;    // Source pixels each output pixel depends on
+
+    // Anti-aliased coverage of the card's four rounded corners (top-left,
+    // top-right, bottom-left, bottom-right) on the canvas. Everything else
+    // inside the card is fully opaque, so only these tiles need blending.
+    void buildCornerMask() {
+        cv::Mat topLeft = BackgroundLayer::cornerTile(layout.cornerRadius);
+        for (int i = 0; i < 4; ++i) {
+            cornerTiles[i] = cv::Rect();
+        }
+        if (topLeft.empty()) return;
+
+        int size = topLeft.cols;
+        int right = videoRect.x + videoRect.width - size;
+        int bottom = videoRect.y + videoRect.height - size;
+        cornerTiles[0] = cv::Rect(videoRect.x, videoRect.y, size, size);
+        cornerTiles[1] = cv::Rect(right, videoRect.y, size, size);
+        cornerTiles[2] = cv::Rect(videoRect.x, bottom, size, size);
+        cornerTiles[3] = cv::Rect(right, bottom, size, size);
+        cornerCoverage[0] = topLeft;
+        cv::flip(topLeft, cornerCoverage[1], 1);
+        cv::flip(topLeft, cornerCoverage[2], 0);
+        cv::flip(topLeft, cornerCoverage[3], -1);
+    }
+
+    // baseCanvas = background + (video - background) * coverage, in the part
+    // of a corner tile that lies inside canvasRect
+    void blendCorner(const cv::Rect& canvasRect, int corner) {
+        cv::Rect region = canvasRect & cornerTiles[corner];
+        if (region.empty()) return;
+        TRACE_SCOPE("roundedCorners");
+        const cv::Mat& coverage = cornerCoverage[corner];
+        cv::Point offset = region.tl() - cornerTiles[corner].tl();
+        for (int y = 0; y < region.height; ++y) {
+            const uint8_t* bg = background.ptr<uint8_t>(region.y + y) + region.x * 3;
+            const uint8_t* alpha = coverage.ptr<uint8_t>(offset.y + y) + offset.x;
+            uint8_t* dst = baseCanvas.ptr<uint8_t>(region.y + y) + region.x * 3;
+            for (int x = 0; x < region.width; ++x) {
+                int a = alpha[x];
+                for (int c = 0; c < 3; ++c) {
+                    dst[x * 3 + c] = static_cast<uint8_t>(
+                        (dst[x * 3 + c] * a + bg[x * 3 + c] * (255 - a) + 127) / 255);
+                }
+            }
+        }
+    }
+
+    void initialize(const cv::Mat& source) {
+        frameSize = source.size();
+        if (layout.sourceSize != frameSize) {
+            layout = FrameLayout::compute(frameSize, settings, layout.aspect);
+        }
+        videoRect = layout.videoRect;
+        visibleRect = layout.visibleVideoRect();
+
+        buildCornerMask();
+        background = backgroundLayer.render(settings, layout, source);
+        framesSinceBackground = 0;
+        backgroundStale = false;
+        background.copyTo(baseCanvas);
+        background.copyTo(composite);
+        previousCursorRect = cv::Rect();
+    }
+
+    // Tiles of the source frame that differ from the previous one, merged into
+    // horizontal runs so a changed text line becomes one rect instead of many
+    std::vector<cv::Rect> diffSource(const cv::Mat& source) const {
+        TRACE_SCOPE("diffSource");
+        std::vector<cv::Rect> changed;
+        for (int y = 0; y < frameSize.height; y += DIFF_TILE) {
+            int tileHeight = (std::min)(DIFF_TILE, frameSize.height - y);
+            int runStart = -1;
+            for (int x = 0; x <= frameSize.width; x += DIFF_TILE) {
+                bool dirty = false;
+                if (x < frameSize.width) {
+                    cv::Rect tile(x, y, (std::min)(DIFF_TILE, frameSize.width - x), tileHeight);
+                    dirty = cv::norm(source(tile), previousSource(tile), cv::NORM_INF) > 0;
+                }
+                if (dirty && runStart < 0) {
+                    runStart = x;
+                } else if (!dirty && runStart >= 0) {
+                    changed.emplace_back(runStart, y, (std::min)(x, frameSize.width) - runStart, tileHeight);
+                    runStart = -1;
+                }
+            }
+        }
+        return changed;
+    }
+
+    // Re-renders a dynamic background and everything around the card. The card
+    // interior keeps its pixels; its corners are re-rendered so they blend
+    // against the new background.
+    void refreshBackground(const cv::Mat& source) {
+        background = backgroundLayer.render(settings, layout, source);
+        int width = layout.canvasSize.width;
+        int height = layout.canvasSize.height;
+        const cv::Rect bands[4] = {
+            cv::Rect(0, 0, width, visibleRect.y),
+            cv::Rect(0, visibleRect.y + visibleRect.height, width, height - visibleRect.y - visibleRect.height),
+            cv::Rect(0, visibleRect.y, visibleRect.x, visibleRect.height),
+            cv::Rect(visibleRect.x + visibleRect.width, visibleRect.y,
+                     width - visibleRect.x - visibleRect.width, visibleRect.height)};
+        for (const auto& band : bands) {
+            if (!band.empty()) {
+                background(band).copyTo(baseCanvas(band));
+            }
+        }
+        for (const auto& tile : cornerTiles) {
+            renderVideoRegion(source, tile & visibleRect);
+        }
+        framesSinceBackground = 0;
+        backgroundStale = false;
+    }
+
+    // Canvas region whose pixels depend on the given source region
+    cv::Rect mapToCanvas(const cv::Rect& sourceRect) const {
+        double sx = static_cast<double>(videoRect.width) / frameSize.width;
+        double sy = static_cast<double>(videoRect.height) / frameSize.height;
+        int x0 = static_cast<int>(std::floor((sourceRect.x - LANCZOS_RADIUS) * sx)) - 1;
+        int y0 = static_cast<int>(std::floor((sourceRect.y - LANCZOS_RADIUS) * sy)) - 1;
+        int x1 = static_cast<int>(std::ceil((sourceRect.x + sourceRect.width + LANCZOS_RADIUS) * sx)) + 1;
+        int y1 = static_cast<int>(std::ceil((sourceRect.y + sourceRect.height + LANCZOS_RADIUS) * sy)) + 1;
+        cv::Rect canvasRect(cv::Point(x0 + videoRect.x, y0 + videoRect.y),
+                            cv::Point(x1 + videoRect.x, y1 + videoRect.y));
+        return canvasRect & visibleRect;
+    }
+
+    // Renders one canvas region of the scaled video from the source frame and
+    // rounds the corners it touches. Every region uses the same source mapping,
+    // so a partial update produces the same pixels a full-frame render would.
+    void renderVideoRegion(const cv::Mat& source, const cv::Rect& canvasRect) {
+        if (canvasRect.empty()) return;
+        scaleVideoRegion(source, canvasRect);
+        for (int corner = 0; corner < 4; ++corner) {
+            blendCorner(canvasRect, corner);
+        }
+    }
+
+    void scaleVideoRegion(const cv::Mat& source, const cv::Rect& canvasRect) {
+        TRACE_SCOPE("scaleVideo");
+        cv::Mat dst = baseCanvas(canvasRect);
+
+        if (videoRect.size() == frameSize) {
+            source(canvasRect - videoRect.tl()).copyTo(dst);
+            return;
+        }
+
+        // Inverse map (canvas -> source) with the same pixel-centre convention as cv::resize
+        double ax = static_cast<double>(frameSize.width) / videoRect.width;
+        double ay = static_cast<double>(frameSize.height) / videoRect.height;
+        cv::Matx23d inverse(
+            ax, 0, (canvasRect.x - videoRect.x + 0.5) * ax - 0.5,
+            0, ay, (canvasRect.y - videoRect.y + 0.5) * ay - 0.5);
+        cv::warpAffine(source, dst, cv::Mat(inverse), canvasRect.size(),
+                       cv::INTER_LANCZOS4 | cv::WARP_INVERSE_MAP, cv::BORDER_REPLICATE);
+    }
+
+    // Canvas position of a normalized cursor position, kept sub-pixel
+    cv::Point2d toCanvas(const CursorPosition& pos) const {
+        return cv::Point2d(pos.x * videoRect.width + videoRect.x, pos.y * videoRect.height + videoRect.y);
+    }
+
+public:
+    FrameCompositor() : hasPrevious(false), framesSinceBackground(0), backgroundStale(false), cursorMs(0) {}
+
+    void setSettings(const BackgroundSettings& newSettings, const FrameLayout& newLayout) {
+        settings = newSettings;
+        layout = newLayout;
+        hasPrevious = false;
+    }
+
+    // Composites the source frame and cursor into a frame of the layout's canvas size.
+    // The returned frame is owned by the compositor and stays valid until the
+    // next call; the source must not be modified afterwards, since it is kept
+    // as the reference for the next diff. previousPos, the cursor on the
+    // frame before, lets the overlay motion-blur fast moves.
+    const cv::Mat& compose(const cv::Mat& source, CursorOverlay& cursor, const CursorPosition& pos,
+                           const CursorPosition* previousPos = nullptr) {
+        TRACE_SCOPE("FrameCompositor::compose");
+        dirtyRects.clear();
+
+        if (!hasPrevious || source.size() != frameSize) {
+            initialize(source);
+            renderVideoRegion(source, visibleRect);
+            baseCanvas.copyTo(composite);
+            dirtyRects.push_back(cv::Rect(cv::Point(0, 0), layout.canvasSize));
+        } else {
+            std::vector<cv::Rect> changed = diffSource(source);
+            for (const auto& sourceRect : changed) {
+                cv::Rect canvasRect = mapToCanvas(sourceRect);
+                renderVideoRegion(source, canvasRect);
+                dirtyRects.push_back(canvasRect);
+            }
+
+            // A blurred-frame background follows the recording, but at most
+            // every frameBlurInterval frames
+            bool backgroundChanged = false;
+            if (BackgroundLayer::isDynamic(settings)) {
+                backgroundStale = backgroundStale || !changed.empty();
+                if (backgroundStale && ++framesSinceBackground >= settings.frameBlurInterval) {
+                    refreshBackground(source);
+                    backgroundChanged = true;
+                }
+            }
+
+            if (backgroundChanged) {
+                baseCanvas.copyTo(composite);
+                dirtyRects.assign(1, cv::Rect(cv::Point(0, 0), layout.canvasSize));
+            } else {
+                if (!previousCursorRect.empty()) {
+                    dirtyRects.push_back(previousCursorRect);
+                }
+                // Restore everything that changed, including the old cursor footprint
+                for (const auto& rect : dirtyRects) {
+                    baseCanvas(rect).copyTo(composite(rect));
+                }
+            }
+        }
+
+        cursorMs = 0;
+        {
+            StageTimer timer(cursorMs);
+            cv::Point2d cursorAt = toCanvas(pos);
+            previousCursorRect = previousPos
+                ? cursor.overlayMotion(composite, toCanvas(*previousPos), cursorAt, pos.cursorType)
+                : cursor.overlay(composite, cursorAt.x, cursorAt.y, pos.cursorType);
+        }
+        if (!previousCursorRect.empty()) {
+            dirtyRects.push_back(previousCursorRect);
+        }
+
+        previousSource = source;
+        hasPrevious = true;
+        return composite;
+    }
+
+    // Part of the last compose() spent in CursorOverlay::overlay
+    double getCursorMs() const {
+        return cursorMs;
+    }
+
+    // Canvas regions that differ from the previous composite
+    const std::vector<cv::Rect>& getDirtyRects() const {
+        return dirtyRects;
+    }
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include "ZoomConfig.h"
+
+// Output geometry of an export: the canvas size for the requested aspect and
+// where the video sits on it after padding and scale. Resolved once when a
+// project is opened; the compositor, the writer and cursor placement all read
+// it instead of redoing the arithmetic per frame.
+struct FrameLayout {
+    cv::Size sourceSize;
+    cv::Size canvasSize;        // Output frame size
+    cv::Rect videoRect;         // Scaled video on the canvas (may extend past it when scale > 1)
+    double aspect = 0;          // Requested width / height, 0 for the source aspect
+    double cornerRadius = 0;    // Of the video card, in output pixels
+
+    bool operator==(const FrameLayout& other) const {
+        return sourceSize == other.sourceSize && canvasSize == other.canvasSize &&
+               videoRect == other.videoRect && cornerRadius == other.cornerRadius;
+    }
+
+    // Part of the canvas the video actually covers
+    cv::Rect visibleVideoRect() const {
+        return videoRect & cv::Rect(cv::Point(0, 0), canvasSize);
+    }
+
+    // Aspect ratio for a --format value: "16:9", "9:16", "1:1", any "w:h", or
+    // "source"/"gif"/"" to keep the recording's own aspect
+    static bool parseFormat(const std::string& format, double& aspectOut, std::string& error) {
+        if (format.empty() || format == "source" || format == "gif") {
+            aspectOut = 0;
+            return true;
+        }
+        size_t colon = format.find(':');
+        try {
+            if (colon != std::string::npos) {
+                double w = std::stod(format.substr(0, colon));
+                double h = std::stod(format.substr(colon + 1));
+                if (w > 0 && h > 0) {
+                    aspectOut = w / h;
+                    return true;
+                }
+            }
+        } catch (const std::exception&) {
+        }
+        error = "Invalid output format: " + format;
+        return false;
+    }
+
+    // The canvas keeps the recording's shorter side, so 16:9 output of a 16:9
+    // recording is the recording's own size and 9:16 of 1920x1080 is 1080x1920
+    static FrameLayout compute(const cv::Size& source, const BackgroundSettings& settings, double aspect) {
+        FrameLayout layout;
+        layout.sourceSize = source;
+        layout.aspect = aspect;
+
+        auto even = [](double v) { return (std::max)(2, 2 * static_cast<int>(std::lround(v / 2))); };
+        int shortSide = (std::min)(source.width, source.height);
+        if (aspect <= 0) {
+            layout.canvasSize = source;
+        } else if (aspect >= 1) {
+            layout.canvasSize = cv::Size(even(shortSide * aspect), even(shortSide));
+        } else {
+            layout.canvasSize = cv::Size(even(shortSide), even(shortSide / aspect));
+        }
+
+        // Fit the video inside the padded area, then apply the user scale
+        double padding = (std::max)(0.0, settings.padding);
+        double availableWidth = (std::max)(1.0, layout.canvasSize.width - 2 * padding);
+        double availableHeight = (std::max)(1.0, layout.canvasSize.height - 2 * padding);
+        double fit = (std::min)(availableWidth / source.width, availableHeight / source.height) * settings.scale;
+        int width = (std::max)(1, static_cast<int>(std::lround(source.width * fit)));
+        int height = (std::max)(1, static_cast<int>(std::lround(source.height * fit)));
+        layout.videoRect = cv::Rect((layout.canvasSize.width - width) / 2,
+                                    (layout.canvasSize.height - height) / 2, width, height);
+
+        layout.cornerRadius = std::clamp(settings.cornerRadius, 0.0, (std::min)(width, height) / 2.0);
+        return layout;
+    }
+};
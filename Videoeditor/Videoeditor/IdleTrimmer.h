@@ -0,0 +1,115 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "CursorData.h"
+#include "ScreenActivity.h"
+#include "VideoReader.h"
+#include "ZoomConfig.h"
+
+// Source frames first..last (inclusive)
+struct FrameRange {
+    int first;
+    int last;
+
+    int length() const {
+        return last - first + 1;
+    }
+};
+
+// Finds the stretches of a recording where nothing happens, so the export can
+// seek past them instead of decoding them. Candidates come from the cursor
+// track (no movement, no buttons); the screen is then checked by decoding a
+// sample every SAMPLE_SECONDS inside each candidate and comparing neighbouring
+// samples at 1/8 scale, so confirming a cut costs a handful of frames rather
+// than the whole range.
+class IdleTrimmer {
+private:
+    static constexpr double STILL_RADIUS = 0.002;   // Normalized cursor movement still counted as idle
+    static constexpr double SAMPLE_SECONDS = 1.0;
+
+    // Runs of at least minFrames frames where the cursor neither moves nor clicks
+    static std::vector<FrameRange> stillCursorRanges(const CursorData& cursorData, int frameCount, int minFrames) {
+        std::vector<FrameRange> ranges;
+        std::vector<CursorPosition> positions = cursorData.getPositionsForFrames(0, frameCount);
+        int start = 0;
+        for (int i = 1; i <= frameCount; ++i) {
+            bool still = false;
+            if (i < frameCount) {
+                const CursorPosition& anchor = positions[start];
+                const CursorPosition& pos = positions[i];
+                double dx = pos.x - anchor.x;
+                double dy = pos.y - anchor.y;
+                still = dx * dx + dy * dy <= STILL_RADIUS * STILL_RADIUS &&
+                        pos.cursorType == anchor.cursorType && pos.buttons == 0 && anchor.buttons == 0;
+            }
+            if (!still) {
+                if (i - start >= minFrames) {
+                    ranges.push_back({start, i - 1});
+                }
+                start = i;
+            }
+        }
+        return ranges;
+    }
+
+public:
+    // Idle ranges to cut, in order, already shortened by keepSeconds at both ends.
+    // Leaves the reader at an arbitrary position.
+    static bool findCuts(VideoReader& reader, const CursorData& cursorData, const TrimSettings& settings,
+                         double fps, std::vector<FrameRange>& cuts, std::string& error) {
+        cuts.clear();
+        int frameCount = reader.getTotalFrames();
+        int minFrames = (std::max)(1, static_cast<int>(std::lround(settings.minIdleSeconds * fps)));
+        int keepFrames = (std::max)(0, static_cast<int>(std::lround(settings.keepSeconds * fps)));
+        int step = (std::max)(1, static_cast<int>(std::lround(SAMPLE_SECONDS * fps)));
+
+        cv::Mat frame, small, gray, previousGray;
+        for (const FrameRange& candidate : stillCursorRanges(cursorData, frameCount, minFrames)) {
+            // Split the candidate wherever two neighbouring samples differ
+            int idleStart = candidate.first;
+            int previousSample = -1;
+            for (int sample = candidate.first; ; sample = (std::min)(sample + step, candidate.last)) {
+                if (!reader.seekFrame(sample) || !reader.readFrame(frame)) {
+                    error = "Could not read frame " + std::to_string(sample) + " while looking for idle ranges";
+                    return false;
+                }
+                ActivityAnalyzer::downsample(frame, small, gray);
+                if (previousSample >= 0 && ActivityAnalyzer::magnitude(gray, previousGray) > settings.threshold) {
+                    if (previousSample - idleStart + 1 >= minFrames) {
+                        cuts.push_back({idleStart, previousSample});
+                    }
+                    idleStart = sample;
+                }
+                std::swap(gray, previousGray);
+                previousSample = sample;
+                if (sample == candidate.last) break;
+            }
+            if (candidate.last - idleStart + 1 >= minFrames) {
+                cuts.push_back({idleStart, candidate.last});
+            }
+        }
+
+        // Keep a moment of each idle stretch so the viewer sees the pause
+        std::vector<FrameRange> trimmed;
+        for (const FrameRange& cut : cuts) {
+            FrameRange shortened{cut.first + keepFrames, cut.last - keepFrames};
+            if (shortened.length() > 0) {
+                trimmed.push_back(shortened);
+            }
+        }
+        cuts = std::move(trimmed);
+        return true;
+    }
+
+    // Frames left after the cuts
+    static int remainingFrames(int frameCount, const std::vector<FrameRange>& cuts) {
+        int remaining = frameCount;
+        for (const FrameRange& cut : cuts) {
+            remaining -= cut.length();
+        }
+        return (std::max)(0, remaining);
+    }
+};
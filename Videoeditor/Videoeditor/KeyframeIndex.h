@@ -0,0 +1,179 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// Keyframe positions, PTS and packet sizes of a video in display order.
+// Built with a demux-only pass (no decoding) the first time a video is opened
+// for random access and saved next to it as "<video>.osindex".
+class KeyframeIndex {
+private:
+    std::vector<int> keyframes;          // Display indices of keyframes, ascending
+    std::vector<int64_t> pts;            // PTS of each frame in display order
+    std::vector<int> packetSizes;        // Compressed size of each frame in bytes
+    uintmax_t sourceSize = 0;            // Size and mtime of the video the index was built from
+    int64_t sourceModified = 0;
+    bool valid = false;
+
+    static const int FORMAT_VERSION = 1;
+
+    static std::string indexPath(const std::string& videoPath) {
+        return videoPath + ".osindex";
+    }
+
+    static bool statVideo(const std::string& videoPath, uintmax_t& size, int64_t& modified) {
+        std::error_code ec;
+        size = std::filesystem::file_size(videoPath, ec);
+        if (ec) return false;
+        auto time = std::filesystem::last_write_time(videoPath, ec);
+        if (ec) return false;
+        modified = static_cast<int64_t>(time.time_since_epoch().count());
+        return true;
+    }
+
+    bool load(const std::string& videoPath) {
+        std::ifstream file(indexPath(videoPath));
+        if (!file.is_open()) return false;
+
+        try {
+            nlohmann::json j;
+            file >> j;
+            if (j.value("version", 0) != FORMAT_VERSION) return false;
+
+            uintmax_t size;
+            int64_t modified;
+            if (!statVideo(videoPath, size, modified) ||
+                j["sourceSize"].get<uintmax_t>() != size ||
+                j["sourceModified"].get<int64_t>() != modified) {
+                return false;  // Video changed since the index was written
+            }
+
+            keyframes = j["keyframes"].get<std::vector<int>>();
+            pts = j["pts"].get<std::vector<int64_t>>();
+            packetSizes = j["packetSizes"].get<std::vector<int>>();
+            sourceSize = size;
+            sourceModified = modified;
+            valid = !pts.empty() && !keyframes.empty();
+            return valid;
+        }
+        catch (const nlohmann::json::exception&) {
+            return false;
+        }
+    }
+
+    void save(const std::string& videoPath) const {
+        nlohmann::json j = {
+            {"version", FORMAT_VERSION},
+            {"sourceSize", sourceSize},
+            {"sourceModified", sourceModified},
+            {"frameCount", pts.size()},
+            {"keyframes", keyframes},
+            {"pts", pts},
+            {"packetSizes", packetSizes}
+        };
+        std::ofstream file(indexPath(videoPath));
+        if (file.is_open()) {
+            file << j.dump();
+        }
+    }
+
+    // Reads packets without decoding them. Packets arrive in decode order, so
+    // they are sorted by PTS to get display order (matters with B-frames).
+    bool scan(const std::string& videoPath) {
+        cv::VideoCapture cap;
+        if (!cap.open(videoPath, cv::CAP_FFMPEG, {cv::CAP_PROP_FORMAT, -1})) {
+            return false;
+        }
+
+        struct Packet {
+            int64_t pts;
+            int size;
+            bool key;
+        };
+        std::vector<Packet> packets;
+        cv::Mat raw;
+        while (cap.grab()) {
+            Packet packet;
+            packet.pts = static_cast<int64_t>(cap.get(cv::CAP_PROP_PTS));
+            packet.key = cap.get(cv::CAP_PROP_LRF_HAS_KEY_FRAME) != 0;
+            packet.size = cap.retrieve(raw) ? static_cast<int>(raw.total() * raw.elemSize()) : 0;
+            packets.push_back(packet);
+        }
+        if (packets.empty()) return false;
+
+        std::stable_sort(packets.begin(), packets.end(),
+            [](const Packet& a, const Packet& b) { return a.pts < b.pts; });
+
+        keyframes.clear();
+        pts.resize(packets.size());
+        packetSizes.resize(packets.size());
+        for (size_t i = 0; i < packets.size(); i++) {
+            pts[i] = packets[i].pts;
+            packetSizes[i] = packets[i].size;
+            if (packets[i].key) {
+                keyframes.push_back(static_cast<int>(i));
+            }
+        }
+        // A stream always starts decodable at frame 0 for seeking purposes
+        if (keyframes.empty() || keyframes.front() != 0) {
+            keyframes.insert(keyframes.begin(), 0);
+        }
+        return true;
+    }
+
+public:
+    // Loads the saved index for the video, or builds and saves a new one.
+    // Returns false when the backend cannot demux raw packets; callers then
+    // fall back to plain CAP_PROP_POS_FRAMES seeking.
+    bool open(const std::string& videoPath) {
+        valid = false;
+        if (load(videoPath)) {
+            return true;
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+        if (!statVideo(videoPath, sourceSize, sourceModified) || !scan(videoPath)) {
+            std::cerr << "Could not build keyframe index for " << videoPath << std::endl;
+            return false;
+        }
+        valid = true;
+        save(videoPath);
+
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        std::cout << "Built keyframe index: " << pts.size() << " frames, "
+                  << keyframes.size() << " keyframes in " << ms << " ms" << std::endl;
+        return true;
+    }
+
+    bool isValid() const {
+        return valid;
+    }
+
+    int getFrameCount() const {
+        return static_cast<int>(pts.size());
+    }
+
+    // Nearest keyframe at or before the frame; decoding from it reaches the frame
+    int keyframeAtOrBefore(int frameIndex) const {
+        auto it = std::upper_bound(keyframes.begin(), keyframes.end(), frameIndex);
+        return it == keyframes.begin() ? 0 : *(it - 1);
+    }
+
+    const std::vector<int>& getKeyframes() const {
+        return keyframes;
+    }
+
+    int64_t getPts(int frameIndex) const {
+        return pts[frameIndex];
+    }
+
+    int getPacketSize(int frameIndex) const {
+        return packetSizes[frameIndex];
+    }
+};
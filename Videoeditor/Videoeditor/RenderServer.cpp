@@ -0,0 +1,533 @@
+// Platform socket headers must come before anything that pulls in <windows.h>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "RenderServer.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+
+#ifdef _WIN32
+typedef SOCKET SocketHandle;
+static const SocketHandle INVALID_SOCKET_HANDLE = INVALID_SOCKET;
+static void closeSocket(SocketHandle s) { closesocket(s); }
+#else
+typedef int SocketHandle;
+static const SocketHandle INVALID_SOCKET_HANDLE = -1;
+static void closeSocket(SocketHandle s) { close(s); }
+#endif
+
+// A client that goes away mid-reply must not take the server down: with
+// SIGPIPE ignored, writes to a closed pipe or socket fail with EPIPE instead,
+// which the channels treat as a disconnect
+static void ignoreBrokenPipe() {
+#ifndef _WIN32
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+}
+
+using json = nlohmann::json;
+
+// A bidirectional stream of text lines
+class LineChannel {
+public:
+    virtual ~LineChannel() = default;
+    virtual bool readLine(std::string& line) = 0;
+    virtual void writeLine(const std::string& line) = 0;
+};
+
+// Commands on stdin, replies on the original stdout. Regular log output is
+// redirected to stderr for the lifetime of the channel so it cannot corrupt
+// the protocol stream.
+class StdioChannel : public LineChannel {
+private:
+    std::ostream protocolOut;
+    std::streambuf* originalCout;
+
+public:
+    StdioChannel() : protocolOut(std::cout.rdbuf()), originalCout(std::cout.rdbuf()) {
+        std::cout.rdbuf(std::cerr.rdbuf());
+    }
+
+    ~StdioChannel() override {
+        std::cout.rdbuf(originalCout);
+    }
+
+    bool readLine(std::string& line) override {
+        return static_cast<bool>(std::getline(std::cin, line));
+    }
+
+    void writeLine(const std::string& line) override {
+        if (!protocolOut) return;  // Parent closed its end of the pipe
+        protocolOut << line << '\n' << std::flush;
+    }
+};
+
+class SocketChannel : public LineChannel {
+private:
+    SocketHandle client;
+    std::string pending;
+    bool open = true;
+
+public:
+    explicit SocketChannel(SocketHandle clientSocket) : client(clientSocket) {}
+
+    ~SocketChannel() override {
+        closeSocket(client);
+    }
+
+    bool readLine(std::string& line) override {
+        while (true) {
+            size_t newline = pending.find('\n');
+            if (newline != std::string::npos) {
+                line = pending.substr(0, newline);
+                pending.erase(0, newline + 1);
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                return true;
+            }
+            char buffer[4096];
+            int received = static_cast<int>(::recv(client, buffer, sizeof(buffer), 0));
+            if (received <= 0) {
+                open = false;
+                return false;
+            }
+            pending.append(buffer, received);
+        }
+    }
+
+    void writeLine(const std::string& line) override {
+        if (!open) return;
+        std::string data = line + "\n";
+        size_t sent = 0;
+        while (sent < data.size()) {
+            int n = static_cast<int>(::send(client, data.data() + sent, static_cast<int>(data.size() - sent), 0));
+            if (n <= 0) {
+                open = false;  // Client disconnected (EPIPE) or the socket failed
+                return;
+            }
+            sent += n;
+        }
+    }
+};
+
+RenderServer::RenderServer(const CursorOverlay& loadedCursor) : cursorPrototype(loadedCursor) {}
+
+RenderServer::~RenderServer() {
+    stopWorkers();
+}
+
+void RenderServer::startWorkers() {
+    stopping = false;
+    renderWorker = std::thread(&RenderServer::renderLoop, this);
+    previewWorker = std::thread(&RenderServer::previewLoop, this);
+}
+
+void RenderServer::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+        if (renderActive && activeRender.cancelled) {
+            activeRender.cancelled->store(true);
+        }
+        renderQueue.clear();
+        pendingPreview.reset();
+    }
+    queueChanged.notify_all();
+    if (renderWorker.joinable()) renderWorker.join();
+    if (previewWorker.joinable()) previewWorker.join();
+}
+
+void RenderServer::send(const json& message) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    if (channel) {
+        channel->writeLine(message.dump());
+    }
+}
+
+void RenderServer::sendError(const std::string& id, const std::string& message) {
+    send({{"event", "error"}, {"id", id}, {"message", message}});
+}
+
+bool RenderServer::parseJob(const json& command, ExportJob& job, std::string& error) {
+    job.inputPath = command.value("input", "");
+    job.outputPath = command.value("output", "");
+    job.cursorDataPath = command.value("cursorData", "");
+    job.zoomConfigPath = command.value("zoomConfig", "");
+    job.format = command.value("format", "");
+    if (job.inputPath.empty() || job.cursorDataPath.empty() || job.zoomConfigPath.empty()) {
+        error = "input, cursorData and zoomConfig are required";
+        return false;
+    }
+    if (job.outputPath.empty()) {
+        error = "output is required";
+        return false;
+    }
+    return true;
+}
+
+json RenderServer::statusMessage() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    json queued = json::array();
+    for (const auto& request : renderQueue) {
+        queued.push_back(request.id);
+    }
+    json status = {{"event", "status"}, {"queued", queued}};
+    status["active"] = renderActive ? json(activeRender.id) : json(nullptr);
+    return status;
+}
+
+// Returns false when the server should shut down
+bool RenderServer::handleLine(const std::string& line) {
+    if (line.empty()) return true;
+
+    json command;
+    try {
+        command = json::parse(line);
+    }
+    catch (const json::exception& e) {
+        sendError("", "Invalid JSON: " + std::string(e.what()));
+        return true;
+    }
+
+    if (!command.is_object()) {
+        sendError("", "Command must be a JSON object");
+        return true;
+    }
+    std::string id = command.contains("id") && command["id"].is_string() ? command["id"].get<std::string>() : "";
+
+    // Fields of the wrong type throw from value()/get(); answer those instead of dying
+    try {
+        return handleCommand(command, id);
+    }
+    catch (const json::exception& e) {
+        sendError(id, "Invalid command: " + std::string(e.what()));
+        return true;
+    }
+}
+
+bool RenderServer::handleCommand(const json& command, const std::string& id) {
+    std::string cmd = command.value("cmd", "");
+
+    if (cmd == "render-frame") {
+        cmd = "preview-frame";  // Same request, named after the CLI entry point
+    }
+
+    if (cmd == "render" || cmd == "preview-frame") {
+        ExportJob job;
+        std::string error;
+        if (!parseJob(command, job, error)) {
+            sendError(id, error);
+            return true;
+        }
+        int frameIndex = command.value("frame", 0);
+        if (frameIndex < 0) {
+            sendError(id, "frame must not be negative");
+            return true;
+        }
+
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (cmd == "render") {
+            renderQueue.push_back({id, job, std::make_shared<std::atomic<bool>>(false)});
+            Trace::counter("renderQueue", static_cast<int64_t>(renderQueue.size()));
+            send({{"event", "queued"}, {"id", id}, {"position", renderQueue.size()}});
+        } else {
+            if (pendingPreview) {
+                send({{"event", "superseded"}, {"id", pendingPreview->id}});
+                Trace::instant("preview superseded");
+            }
+            pendingPreview = std::make_unique<PreviewRequest>();
+            pendingPreview->id = id;
+            pendingPreview->job = job;
+            pendingPreview->frameIndex = frameIndex;
+        }
+        queueChanged.notify_all();
+    }
+    else if (cmd == "thumbnails") {
+        ThumbnailRequest request;
+        request.id = id;
+        request.inputPath = command.value("input", "");
+        request.outputPath = command.value("output", "");
+        request.options.count = command.value("count", request.options.count);
+        request.options.height = command.value("height", request.options.height);
+        request.options.columns = command.value("columns", request.options.columns);
+        if (request.inputPath.empty() || request.outputPath.empty()) {
+            sendError(id, "input and output are required");
+            return true;
+        }
+
+        std::lock_guard<std::mutex> lock(queueMutex);
+        thumbnailQueue.push_back(request);
+        Trace::instant("thumbnails queued");
+        queueChanged.notify_all();
+    }
+    else if (cmd == "cancel") {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        bool found = false;
+        if (renderActive && activeRender.id == id) {
+            activeRender.cancelled->store(true);
+            found = true;
+        }
+        for (auto it = renderQueue.begin(); it != renderQueue.end(); ++it) {
+            if (it->id == id) {
+                renderQueue.erase(it);
+                send({{"event", "cancelled"}, {"id", id}});
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            sendError(id, "No queued or running job with this id");
+        }
+    }
+    else if (cmd == "status") {
+        json status = statusMessage();
+        status["id"] = id;
+        send(status);
+    }
+    else if (cmd == "shutdown") {
+        send({{"event", "shutdown"}, {"id", id}});
+        return false;
+    }
+    else {
+        sendError(id, "Unknown command: " + cmd);
+    }
+    return true;
+}
+
+void RenderServer::renderLoop() {
+    Trace::setThreadName("render worker");
+    ExportPipeline pipeline(cursorPrototype);
+
+    while (true) {
+        RenderRequest request;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueChanged.wait(lock, [this] { return stopping || !renderQueue.empty(); });
+            if (stopping) return;
+            request = renderQueue.front();
+            renderQueue.pop_front();
+            Trace::counter("renderQueue", static_cast<int64_t>(renderQueue.size()));
+            activeRender = request;
+            renderActive = true;
+        }
+
+        send({{"event", "started"}, {"id", request.id}});
+        auto startTime = std::chrono::steady_clock::now();
+
+        // Each render reopens the project so it decodes from a fresh capture
+        auto project = std::make_unique<Project>();
+        bool ok = false;
+        std::string error;
+        try {
+            ok = project->open(request.job);
+            error = project->getLastError();
+            if (ok) {
+                auto lastReport = std::chrono::steady_clock::now();
+                ProgressJsonWriter progressWriter;
+                ok = pipeline.run(*project, request.job.outputPath, request.cancelled.get(),
+                    [&](const ExportProgress& progress) {
+                        auto now = std::chrono::steady_clock::now();
+                        if (now - lastReport < std::chrono::milliseconds(250)) return;
+                        lastReport = now;
+                        json message = progressWriter.next(progress);
+                        message["id"] = request.id;
+                        send(message);
+                    });
+                error = pipeline.getLastError();
+            }
+        }
+        catch (const std::exception& e) {
+            // e.g. cv::Exception from the decoder or encoder: fail this job, keep serving
+            ok = false;
+            error = "Render failed: " + std::string(e.what());
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        if (ok) {
+            send({{"event", "done"}, {"id", request.id}, {"output", request.job.outputPath}, {"seconds", seconds}});
+        } else if (request.cancelled->load()) {
+            send({{"event", "cancelled"}, {"id", request.id}});
+        } else {
+            sendError(request.id, error);
+        }
+
+        std::lock_guard<std::mutex> lock(queueMutex);
+        renderActive = false;
+    }
+}
+
+void RenderServer::previewLoop() {
+    Trace::setThreadName("preview worker");
+    ExportPipeline pipeline(cursorPrototype);
+    std::unique_ptr<Project> project;
+
+    while (true) {
+        std::unique_ptr<PreviewRequest> request;
+        std::unique_ptr<ThumbnailRequest> thumbnails;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueChanged.wait(lock, [this] {
+                return stopping || pendingPreview || !thumbnailQueue.empty();
+            });
+            if (stopping) return;
+
+            // A waiting preview goes first: the user is looking at it
+            if (pendingPreview) {
+                request = std::move(pendingPreview);
+            } else {
+                thumbnails = std::make_unique<ThumbnailRequest>(thumbnailQueue.front());
+                thumbnailQueue.pop_front();
+            }
+        }
+
+        if (thumbnails) {
+            try {
+                generateThumbnails(*thumbnails);
+            }
+            catch (const std::exception& e) {
+                sendError(thumbnails->id, "Thumbnails failed: " + std::string(e.what()));
+            }
+            continue;
+        }
+
+        try {
+            renderPreview(*request, pipeline, project);
+        }
+        catch (const std::exception& e) {
+            // The project may be half-opened or mid-decode; reopen it on the next request
+            project.reset();
+            sendError(request->id, "Preview failed: " + std::string(e.what()));
+        }
+    }
+}
+
+void RenderServer::renderPreview(const PreviewRequest& request, ExportPipeline& pipeline,
+                                 std::unique_ptr<Project>& project) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Keep the project open while the editor keeps scrubbing the same recording
+    if (!project || !project->job.sameProject(request.job)) {
+        project = std::make_unique<Project>();
+        if (!project->open(request.job, true)) {
+            sendError(request.id, project->getLastError());
+            project.reset();
+            return;
+        }
+    }
+
+    cv::Mat frame;
+    if (!pipeline.renderFrame(*project, request.frameIndex, frame)) {
+        sendError(request.id, pipeline.getLastError());
+        return;
+    }
+    std::string error;
+    if (!ExportPipeline::saveFrame(frame, request.job.outputPath, error)) {
+        sendError(request.id, error);
+        return;
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    send({{"event", "frame"}, {"id", request.id}, {"frame", request.frameIndex},
+          {"output", request.job.outputPath}, {"width", frame.cols}, {"height", frame.rows},
+          {"ms", ms}});
+}
+
+void RenderServer::generateThumbnails(const ThumbnailRequest& request) {
+    auto startTime = std::chrono::steady_clock::now();
+    ThumbnailGenerator generator;
+    if (!generator.generate(request.inputPath, request.outputPath, request.options)) {
+        sendError(request.id, generator.getLastError());
+        return;
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    send({{"event", "thumbnails"}, {"id", request.id}, {"output", request.outputPath},
+          {"index", ThumbnailGenerator::getIndexPath(request.outputPath)}, {"ms", ms}});
+}
+
+int RenderServer::serve(LineChannel& lineChannel) {
+    {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        channel = &lineChannel;
+    }
+    send({{"event", "ready"}});
+
+    bool keepRunning = true;
+    std::string line;
+    while (keepRunning && lineChannel.readLine(line)) {
+        keepRunning = handleLine(line);
+    }
+
+    std::lock_guard<std::mutex> lock(outputMutex);
+    channel = nullptr;
+    return keepRunning ? 1 : 0;  // 1: client went away, 0: shutdown requested
+}
+
+int RenderServer::serveStdio() {
+    ignoreBrokenPipe();
+    StdioChannel stdio;
+    startWorkers();
+    serve(stdio);
+    stopWorkers();
+    return 0;
+}
+
+int RenderServer::serveSocket(const std::string& socketPath) {
+    ignoreBrokenPipe();
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::cerr << "Error: WSAStartup failed" << std::endl;
+        return -1;
+    }
+#endif
+
+    SocketHandle listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener == INVALID_SOCKET_HANDLE) {
+        std::cerr << "Error: Could not create socket" << std::endl;
+        return -1;
+    }
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Socket path is too long: " << socketPath << std::endl;
+        closeSocket(listener);
+        return -1;
+    }
+    std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", socketPath.c_str());
+    std::remove(socketPath.c_str());  // Stale socket from a previous run
+
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listener, 1) != 0) {
+        std::cerr << "Error: Could not listen on " << socketPath << std::endl;
+        closeSocket(listener);
+        return -1;
+    }
+
+    std::cout << "Render server listening on " << socketPath << std::endl;
+    startWorkers();
+
+    // Jobs keep running when a client disconnects; the next client sees their events
+    int result = 1;
+    while (result == 1) {
+        SocketHandle client = accept(listener, nullptr, nullptr);
+        if (client == INVALID_SOCKET_HANDLE) break;
+        SocketChannel clientChannel(client);
+        result = serve(clientChannel);
+    }
+
+    stopWorkers();
+    closeSocket(listener);
+    std::remove(socketPath.c_str());
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    return 0;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <nlohmann/json.hpp>
+#include "CursorOverlay.h"
+#include "ExportPipeline.h"
+#include "ThumbnailGenerator.h"
+
+class LineChannel;
+
+// Resident render process driven by JSON-lines commands (see --serve).
+// Cursor sprites are loaded once by the caller and shared by every job; the
+// last opened project and OpenCV's worker threads stay warm between requests.
+//
+// Commands, one JSON object per line:
+//   {"cmd":"render","id":"a","input":"..","output":"..","cursorData":"..","zoomConfig":".."}
+//   {"cmd":"preview-frame","id":"b","input":"..","cursorData":"..","zoomConfig":"..","frame":120,"output":"frame.png"}
+//     ("render-frame" is accepted as an alias; an output ending in .bgra gets raw BGRA bytes)
+//   {"cmd":"thumbnails","id":"c","input":"..","output":"strip.jpg","count":100,"height":90}
+//     (writes the sprite sheet plus strip.json; runs on the preview worker)
+//   {"cmd":"cancel","id":"a"}
+//   {"cmd":"status"}
+//   {"cmd":"shutdown"}
+// Every reply is a JSON line with an "event" field and the request "id".
+class RenderServer {
+public:
+    explicit RenderServer(const CursorOverlay& loadedCursor);
+    ~RenderServer();
+
+    // Serves commands from stdin and replies on stdout until EOF or shutdown
+    int serveStdio();
+
+    // Serves one client at a time on a Unix-domain socket until shutdown
+    int serveSocket(const std::string& socketPath);
+
+private:
+    struct RenderRequest {
+        std::string id;
+        ExportJob job;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+    };
+
+    struct PreviewRequest {
+        std::string id;
+        ExportJob job;
+        int frameIndex = 0;
+    };
+
+    struct ThumbnailRequest {
+        std::string id;
+        std::string inputPath;
+        std::string outputPath;
+        ThumbnailOptions options;
+    };
+
+    CursorOverlay cursorPrototype;
+
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    std::deque<RenderRequest> renderQueue;
+    std::unique_ptr<PreviewRequest> pendingPreview;  // Newest request wins while scrubbing
+    std::deque<ThumbnailRequest> thumbnailQueue;
+    RenderRequest activeRender;
+    bool renderActive = false;
+    bool stopping = false;
+
+    std::mutex outputMutex;
+    LineChannel* channel = nullptr;
+
+    std::thread renderWorker;
+    std::thread previewWorker;
+
+    void startWorkers();
+    void stopWorkers();
+    bool handleLine(const std::string& line);
+    bool handleCommand(const nlohmann::json& command, const std::string& id);
+    void send(const nlohmann::json& message);
+    void sendError(const std::string& id, const std::string& message);
+    int serve(LineChannel& lineChannel);
+
+    void renderLoop();
+    void previewLoop();
+    void renderPreview(const PreviewRequest& request, ExportPipeline& pipeline, std::unique_ptr<Project>& project);
+    void generateThumbnails(const ThumbnailRequest& request);
+    nlohmann::json statusMessage();
+
+    static bool parseJob(const nlohmann::json& command, ExportJob& job, std::string& error);
+};
@@ -0,0 +1,108 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// Where on screen things changed in one frame
+struct ActivitySample {
+    double x = 0.5;           // Normalized centroid of the change (0-1)
+    double y = 0.5;
+    double magnitude = 0.0;   // Mean absolute difference from the previous frame (0-1)
+};
+
+// Tracks on-screen activity from the decoded frames. Each frame is reduced to
+// 1/8 scale grayscale and differenced against the previous one; the change
+// gives a per-frame centroid and magnitude and feeds a decaying heatmap of
+// where activity has been recently. Working at 1/64 of the pixels keeps the
+// whole pass a small fraction of decode time, so it runs beside decode in the
+// export instead of needing its own pass over the video.
+class ActivityAnalyzer {
+private:
+    static constexpr int SCALE = 8;
+    static constexpr double NOISE_THRESHOLD = 12;   // Gray levels of difference ignored as compression noise
+    static constexpr double HEAT_DECAY = 0.9;       // Heatmap weight kept per frame
+
+    cv::Mat small;
+    cv::Mat gray;
+    cv::Mat previous;
+    cv::Mat changed;
+    cv::Mat heatmap;     // CV_32F, 1/8 scale
+    std::vector<ActivitySample> samples;
+
+public:
+    void reset() {
+        previous.release();
+        heatmap.release();
+        samples.clear();
+    }
+
+    // 1/8 scale grayscale copy of a frame, the resolution all analysis runs at
+    static void downsample(const cv::Mat& frame, cv::Mat& small, cv::Mat& gray) {
+        cv::Size size((std::max)(1, frame.cols / SCALE), (std::max)(1, frame.rows / SCALE));
+        cv::resize(frame, small, size, 0, 0, cv::INTER_AREA);
+        if (small.channels() == 3) {
+            cv::cvtColor(small, gray, cv::COLOR_BGR2GRAY);
+        } else {
+            small.copyTo(gray);
+        }
+    }
+
+    // Per-pixel change between two downsampled frames, with noise zeroed
+    static void difference(const cv::Mat& a, const cv::Mat& b, cv::Mat& diff) {
+        cv::absdiff(a, b, diff);
+        cv::threshold(diff, diff, NOISE_THRESHOLD, 0, cv::THRESH_TOZERO);
+    }
+
+    // Mean change between two downsampled frames (0-1)
+    static double magnitude(const cv::Mat& a, const cv::Mat& b) {
+        cv::Mat diff;
+        difference(a, b, diff);
+        return cv::sum(diff)[0] / (255.0 * diff.total());
+    }
+
+    // Analyzes the next frame in decode order and returns its sample
+    const ActivitySample& analyze(const cv::Mat& frame) {
+        downsample(frame, small, gray);
+
+        ActivitySample sample;
+        if (previous.size() != gray.size()) {
+            heatmap = cv::Mat::zeros(gray.size(), CV_32F);
+        } else {
+            difference(gray, previous, changed);
+
+            cv::Moments moments = cv::moments(changed);
+            if (moments.m00 > 0) {
+                sample.x = (moments.m10 / moments.m00 + 0.5) / gray.cols;
+                sample.y = (moments.m01 / moments.m00 + 0.5) / gray.rows;
+                sample.magnitude = moments.m00 / (255.0 * gray.total());
+            }
+            cv::accumulateWeighted(changed, heatmap, 1.0 - HEAT_DECAY);
+        }
+        std::swap(previous, gray);
+
+        samples.push_back(sample);
+        return samples.back();
+    }
+
+    // Recent activity, decayed over time, at 1/8 of the frame size
+    const cv::Mat& getHeatmap() const {
+        return heatmap;
+    }
+
+    // Normalized centre of the hottest heatmap cell, or the frame centre when
+    // nothing has changed yet
+    cv::Point2d hottestPoint() const {
+        if (heatmap.empty()) return cv::Point2d(0.5, 0.5);
+        double maxValue = 0;
+        cv::Point location;
+        cv::minMaxLoc(heatmap, nullptr, &maxValue, nullptr, &location);
+        if (maxValue <= 0) return cv::Point2d(0.5, 0.5);
+        return cv::Point2d((location.x + 0.5) / heatmap.cols, (location.y + 0.5) / heatmap.rows);
+    }
+
+    // One sample per analyzed frame, in frame order
+    const std::vector<ActivitySample>& getSamples() const {
+        return samples;
+    }
+};
@@ -0,0 +1,166 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "KeyframeIndex.h"
+#include "Trace.h"
+
+struct ThumbnailOptions {
+    int count = 100;      // Requested thumbnails, evenly spaced over the clip
+    int height = 90;      // Tile height in pixels; width follows the video aspect
+    int columns = 10;     // Tiles per sprite-sheet row
+};
+
+// Builds the timeline filmstrip: one sprite sheet plus a JSON index next to it
+// ("<sprite name>.json"). Each requested timestamp snaps to its nearest
+// keyframe and that frame is read, so the cost scales with the thumbnail count
+// rather than the clip length. Reading a keyframe is not a single decode:
+// OpenCV's FFmpeg backend seeks a little before the target (about 16 frames),
+// lands on the keyframe before that and decodes forward, so each thumbnail
+// costs up to one GOP of decoding plus those frames. The end-to-end benchmark
+// reports the measured cost per thumbnail in frames of sequential decode.
+class ThumbnailGenerator {
+private:
+    std::string lastError;
+
+    // Nearest keyframe to each evenly spaced timestamp, deduplicated. Long GOPs
+    // can make neighbouring timestamps snap to the same keyframe.
+    static std::vector<int> pickFrames(const KeyframeIndex* index, int totalFrames, int count) {
+        std::vector<int> frames;
+        for (int i = 0; i < count; i++) {
+            int target = static_cast<int>((i + 0.5) * totalFrames / count);
+            int frame = target;
+            if (index) {
+                const std::vector<int>& keyframes = index->getKeyframes();
+                auto after = std::lower_bound(keyframes.begin(), keyframes.end(), target);
+                if (after == keyframes.end()) {
+                    frame = keyframes.back();
+                } else if (after == keyframes.begin() || *after - target < target - *(after - 1)) {
+                    frame = *after;
+                } else {
+                    frame = *(after - 1);
+                }
+            }
+            if (frames.empty() || frames.back() != frame) {
+                frames.push_back(frame);
+            }
+        }
+        return frames;
+    }
+
+public:
+    bool generate(const std::string& videoPath, const std::string& spritePath,
+                  const ThumbnailOptions& options = ThumbnailOptions()) {
+        cv::VideoCapture probe(videoPath);
+        if (!probe.isOpened()) {
+            lastError = "Could not open video file: " + videoPath;
+            return false;
+        }
+        int videoWidth = static_cast<int>(probe.get(cv::CAP_PROP_FRAME_WIDTH));
+        int videoHeight = static_cast<int>(probe.get(cv::CAP_PROP_FRAME_HEIGHT));
+        double fps = probe.get(cv::CAP_PROP_FPS);
+        if (fps <= 0) fps = 30.0;
+        probe.release();
+
+        // Without an index every thumbnail costs a full seek, but still works
+        KeyframeIndex index;
+        bool indexed = index.open(videoPath);
+        int totalFrames = indexed ? index.getFrameCount()
+                                  : static_cast<int>(cv::VideoCapture(videoPath).get(cv::CAP_PROP_FRAME_COUNT));
+        if (totalFrames <= 0 || videoWidth <= 0 || videoHeight <= 0 || options.count <= 0) {
+            lastError = "Nothing to generate thumbnails from";
+            return false;
+        }
+
+        std::vector<int> frames = pickFrames(indexed ? &index : nullptr, totalFrames, options.count);
+        int tileHeight = options.height;
+        int tileWidth = (std::max)(1, static_cast<int>(std::lround(static_cast<double>(tileHeight) * videoWidth / videoHeight)));
+        int columns = (std::min)(options.columns, static_cast<int>(frames.size()));
+        int rows = (static_cast<int>(frames.size()) + columns - 1) / columns;
+        cv::Mat sprite(rows * tileHeight, columns * tileWidth, CV_8UC3, cv::Scalar(0, 0, 0));
+
+        // Each worker opens its own capture and walks a contiguous run of
+        // keyframes, downscaling straight into its tiles of the sprite sheet
+        int workers = (std::max)(1, (std::min)({cv::getNumThreads(), 4, static_cast<int>(frames.size())}));
+        std::vector<char> decoded(frames.size(), 0);
+        cv::parallel_for_(cv::Range(0, workers), [&](const cv::Range& range) {
+            for (int w = range.start; w < range.end; w++) {
+                size_t first = frames.size() * w / workers;
+                size_t last = frames.size() * (w + 1) / workers;
+                cv::VideoCapture cap(videoPath);
+                if (!cap.isOpened()) continue;
+
+                cv::Mat frame;
+                for (size_t i = first; i < last; i++) {
+                    {
+                        TRACE_SCOPE("thumbnail decode");
+                        if (!cap.set(cv::CAP_PROP_POS_FRAMES, frames[i]) || !cap.read(frame)) continue;
+                    }
+                    int col = static_cast<int>(i) % columns;
+                    int row = static_cast<int>(i) / columns;
+                    cv::Mat tile = sprite(cv::Rect(col * tileWidth, row * tileHeight, tileWidth, tileHeight));
+                    TRACE_SCOPE("cv::resize thumbnail");
+                    cv::resize(frame, tile, tile.size(), 0, 0, cv::INTER_AREA);
+                    decoded[i] = 1;
+                }
+            }
+        }, workers);
+
+        std::vector<int> params;
+        std::string ext = std::filesystem::path(spritePath).extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        if (ext == ".jpg" || ext == ".jpeg") {
+            params = {cv::IMWRITE_JPEG_QUALITY, 80};
+        } else if (ext == ".png") {
+            params = {cv::IMWRITE_PNG_COMPRESSION, 1};
+        }
+        if (!cv::imwrite(spritePath, sprite, params)) {
+            lastError = "Could not write " + spritePath;
+            return false;
+        }
+
+        nlohmann::json thumbnails = nlohmann::json::array();
+        for (size_t i = 0; i < frames.size(); i++) {
+            if (!decoded[i]) continue;
+            thumbnails.push_back({
+                {"frame", frames[i]},
+                {"time", frames[i] / fps},
+                {"x", static_cast<int>(i) % columns * tileWidth},
+                {"y", static_cast<int>(i) / columns * tileHeight}
+            });
+        }
+        nlohmann::json result = {
+            {"sprite", std::filesystem::path(spritePath).filename().string()},
+            {"frameCount", totalFrames},
+            {"fps", fps},
+            {"tileWidth", tileWidth},
+            {"tileHeight", tileHeight},
+            {"columns", columns},
+            {"rows", rows},
+            {"thumbnails", thumbnails}
+        };
+
+        std::ofstream file(getIndexPath(spritePath));
+        if (!file.is_open()) {
+            lastError = "Could not write " + getIndexPath(spritePath);
+            return false;
+        }
+        file << result.dump(2);
+        return true;
+    }
+
+    // Path of the JSON index written next to the sprite sheet
+    static std::string getIndexPath(const std::string& spritePath) {
+        std::filesystem::path path(spritePath);
+        return path.replace_extension(".json").string();
+    }
+
+    const std::string& getLastError() const {
+        return lastError;
+    }
+};
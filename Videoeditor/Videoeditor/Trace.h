@@ -0,0 +1,179 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// Scoped timing markers dumped in Chrome Trace Event format (chrome://tracing,
+// ui.perfetto.dev). Tracing is off unless Trace::start() was called; a
+// disabled marker costs one load and one predictable branch.
+//
+//   TRACE_SCOPE("readFrame");           // Duration of the enclosing scope
+//   Trace::counter("decodeQueue", n);   // Value over time (queue depths)
+//   Trace::instant("job queued");       // Point event
+//
+// Marker names must be string literals: only the pointer is recorded.
+class Trace {
+private:
+    struct Event {
+        const char* name;
+        char phase;         // 'X' complete, 'C' counter, 'i' instant
+        int64_t start;      // Nanoseconds since Trace::start()
+        int64_t duration;   // 'X' only
+        int64_t value;      // 'C' only
+    };
+
+    struct ThreadBuffer {
+        int tid = 0;
+        std::string name;
+        std::mutex mutex;   // Uncontended except while the trace is written
+        std::vector<Event> events;
+    };
+
+    inline static std::atomic<bool> enabledFlag{false};
+    inline static std::chrono::steady_clock::time_point origin;
+    inline static std::mutex buffersMutex;
+    inline static std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+    static ThreadBuffer& threadBuffer() {
+        thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+            auto created = std::make_shared<ThreadBuffer>();
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            created->tid = static_cast<int>(buffers.size()) + 1;
+            buffers.push_back(created);
+            return created;
+        }();
+        return *buffer;
+    }
+
+    static void record(const Event& event) {
+        ThreadBuffer& buffer = threadBuffer();
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.events.push_back(event);
+    }
+
+public:
+    static bool enabled() {
+        return enabledFlag.load(std::memory_order_relaxed);
+    }
+
+    static int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - origin).count();
+    }
+
+    static void start() {
+        origin = std::chrono::steady_clock::now();
+        enabledFlag.store(true);
+    }
+
+    // Stops recording and writes every thread's events to path
+    static bool stop(const std::string& path) {
+        enabledFlag.store(false);
+
+        nlohmann::json events = nlohmann::json::array();
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for (const auto& buffer : buffers) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            if (!buffer->name.empty()) {
+                events.push_back({{"ph", "M"}, {"name", "thread_name"}, {"pid", 1}, {"tid", buffer->tid},
+                                  {"args", {{"name", buffer->name}}}});
+            }
+            for (const Event& event : buffer->events) {
+                nlohmann::json entry = {{"name", event.name}, {"ph", std::string(1, event.phase)},
+                                        {"ts", event.start / 1000.0}, {"pid", 1}, {"tid", buffer->tid}};
+                if (event.phase == 'X') {
+                    entry["dur"] = event.duration / 1000.0;
+                } else if (event.phase == 'C') {
+                    entry["args"] = {{"value", event.value}};
+                } else {
+                    entry["s"] = "t";
+                }
+                events.push_back(entry);
+            }
+            buffer->events.clear();
+        }
+
+        std::ofstream file(path);
+        if (!file.is_open()) {
+            return false;
+        }
+        file << nlohmann::json({{"traceEvents", events}, {"displayTimeUnit", "ms"}}).dump();
+        return static_cast<bool>(file);
+    }
+
+    // Names the calling thread in the trace viewer
+    static void setThreadName(const std::string& name) {
+        ThreadBuffer& buffer = threadBuffer();
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.name = name;
+    }
+
+    static void complete(const char* name, int64_t start, int64_t end) {
+        record({name, 'X', start, end - start, 0});
+    }
+
+    static void counter(const char* name, int64_t value) {
+        if (!enabled()) return;
+        record({name, 'C', now(), 0, value});
+    }
+
+    static void instant(const char* name) {
+        if (!enabled()) return;
+        record({name, 'i', now(), 0, 0});
+    }
+};
+
+// Records the lifetime of the enclosing scope as one complete event
+class TraceScope {
+private:
+    const char* name;
+    int64_t start;
+
+public:
+    explicit TraceScope(const char* markerName) : name(nullptr), start(0) {
+        if (Trace::enabled()) {
+            name = markerName;
+            start = Trace::now();
+        }
+    }
+
+    ~TraceScope() {
+        if (name) {
+            Trace::complete(name, start, Trace::now());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+// Starts tracing for its lifetime when given a path, and writes the file on
+// destruction (after worker threads owned by later locals have joined)
+class TraceSession {
+private:
+    std::string path;
+
+public:
+    explicit TraceSession(const std::string& outputPath) : path(outputPath) {
+        if (!path.empty()) {
+            Trace::start();
+        }
+    }
+
+    ~TraceSession() {
+        if (!path.empty() && !Trace::stop(path)) {
+            std::cerr << "Could not write trace to " << path << std::endl;
+        }
+    }
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
@@ -1,19 +1,220 @@
 #pragma once
 #include <opencv2/opencv.hpp>
+#include <iostream>
+#include <filesystem>
 #include <string>
-#include <windows.h>
+#include "KeyframeIndex.h"
+#include "FrameCache.h"
+#include "Trace.h"
 
+// VideoReader: Handles video file loading and frame reading
 class VideoReader {
 private:
     cv::VideoCapture cap;
     bool isOpen;
     std::string lastError;
+    int nextFrameIndex;  // Frame the next readFrame() returns
+    std::string path;
+
+    // Random access (see enableRandomAccess)
+    KeyframeIndex index;
+    FrameCache cache;
+    bool randomAccess = false;
+    const int CACHE_LOOKBEHIND = 8;  // Frames decoded just before a seek target that get cached
 
 public:
-    VideoReader();
-    bool open(const std::string& filename);
-    bool readFrame(cv::Mat& frame);
-    const std::string& getLastError() const;
-    void release();
-    bool isOpened() const;
-}; 
\ No newline at end of file
+    VideoReader() : isOpen(false), nextFrameIndex(0) {}
+
+    bool open(const std::string& filename) {
+        // Check the file exists first: OpenCV only reports a generic open failure
+        std::error_code ec;
+        if (!std::filesystem::exists(filename, ec)) {
+            lastError = "File does not exist: " + filename;
+            return false;
+        }
+
+        try {
+            isOpen = cap.open(filename);
+            nextFrameIndex = 0;
+            path = filename;
+            randomAccess = false;
+            cache.clear();
+            if (!isOpen) {
+                lastError = "Failed to open video capture for: " + filename;
+                return false;
+            }
+
+            // Get video properties
+            double fps = cap.get(cv::CAP_PROP_FPS);
+            int width = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_WIDTH));
+            int height = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_HEIGHT));
+            int totalFrames = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_COUNT));
+
+            std::cout << "Video opened successfully:" << std::endl
+                     << "Resolution: " << width << "x" << height << std::endl
+                     << "FPS: " << fps << std::endl
+                     << "Total Frames: " << totalFrames << std::endl;
+
+            return true;
+        }
+        catch (const cv::Exception& e) {
+            lastError = "OpenCV Exception: " + std::string(e.what());
+            return false;
+        }
+        catch (const std::exception& e) {
+            lastError = "Standard Exception: " + std::string(e.what());
+            return false;
+        }
+    }
+
+    // Positions the reader so the next readFrame() returns the given frame.
+    // Reading on from the current position needs no seek at all.
+    bool seekFrame(int frameIndex) {
+        if (!isOpen) {
+            lastError = "Attempting to seek in closed video";
+            return false;
+        }
+        if (frameIndex == nextFrameIndex) {
+            return true;
+        }
+        try {
+            if (!cap.set(cv::CAP_PROP_POS_FRAMES, frameIndex)) {
+                lastError = "Could not seek to frame " + std::to_string(frameIndex);
+                return false;
+            }
+            nextFrameIndex = frameIndex;
+            return true;
+        }
+        catch (const cv::Exception& e) {
+            lastError = "Frame seeking error: " + std::string(e.what());
+            return false;
+        }
+    }
+
+    bool readFrame(cv::Mat& frame) {
+        TRACE_SCOPE("readFrame");
+        if (!isOpen) {
+            lastError = "Attempting to read from closed video";
+            return false;
+        }
+        try {
+            if (!cap.read(frame)) {
+                return false;
+            }
+            nextFrameIndex++;
+            return true;
+        }
+        catch (const cv::Exception& e) {
+            lastError = "Frame reading error: " + std::string(e.what());
+            return false;
+        }
+    }
+
+    // Loads or builds the keyframe index and turns on the decoded-frame cache,
+    // so readFrameAt() restarts decoding near the target instead of from the
+    // current position. A restart still decodes from the keyframe OpenCV's
+    // FFmpeg backend lands on, which can be the one before ours (it seeks about
+    // 16 frames early), so a seek costs up to two GOPs of decoding.
+    bool enableRandomAccess(size_t cacheMB = 256) {
+        if (!isOpen) {
+            lastError = "Attempting to index a closed video";
+            return false;
+        }
+        cache.setCapacity(cacheMB);
+        randomAccess = index.open(path);
+        return randomAccess;
+    }
+
+    // Returns any frame by index. Recently decoded frames come from the cache;
+    // otherwise decoding resumes from the current position when no keyframe lies
+    // in between, or restarts from the nearest keyframe before the target.
+    // The returned frame may be shared with the cache and must not be modified.
+    bool readFrameAt(int frameIndex, cv::Mat& frame) {
+        TRACE_SCOPE("readFrameAt");
+        if (frameIndex < 0 || frameIndex >= getTotalFrames()) {
+            lastError = "Frame " + std::to_string(frameIndex) + " is out of range";
+            return false;
+        }
+        if (!randomAccess) {
+            return seekFrame(frameIndex) && readFrame(frame);
+        }
+        if (cache.get(frameIndex, frame)) {
+            return true;
+        }
+
+        int keyframe = index.keyframeAtOrBefore(frameIndex);
+        if (nextFrameIndex < keyframe || nextFrameIndex > frameIndex) {
+            try {
+                if (!cap.set(cv::CAP_PROP_POS_FRAMES, keyframe)) {
+                    lastError = "Could not seek to keyframe " + std::to_string(keyframe);
+                    return false;
+                }
+            }
+            catch (const cv::Exception& e) {
+                lastError = "Frame seeking error: " + std::string(e.what());
+                return false;
+            }
+            nextFrameIndex = keyframe;
+        }
+
+        try {
+            // Skip ahead without converting frames nobody will look at
+            while (nextFrameIndex < frameIndex - CACHE_LOOKBEHIND) {
+                if (!cap.grab()) return false;
+                nextFrameIndex++;
+            }
+            // Frames right before the target are kept for scrubbing backwards
+            while (nextFrameIndex <= frameIndex) {
+                cv::Mat decoded;
+                if (!cap.read(decoded)) return false;
+                cache.put(nextFrameIndex, decoded);
+                if (nextFrameIndex == frameIndex) {
+                    frame = decoded;
+                }
+                nextFrameIndex++;
+            }
+            return true;
+        }
+        catch (const cv::Exception& e) {
+            lastError = "Frame reading error: " + std::string(e.what());
+            return false;
+        }
+    }
+
+    const std::string& getLastError() const {
+        return lastError;
+    }
+
+    void release() {
+        if (isOpen) {
+            cap.release();
+            isOpen = false;
+        }
+    }
+
+    bool isOpened() const { return isOpen; }
+
+    double getFPS() const {
+        return cap.get(cv::CAP_PROP_FPS);
+    }
+
+    int getWidth() const {
+        return static_cast<int>(cap.get(cv::CAP_PROP_FRAME_WIDTH));
+    }
+
+    int getHeight() const {
+        return static_cast<int>(cap.get(cv::CAP_PROP_FRAME_HEIGHT));
+    }
+
+    // Exact when the keyframe index is loaded; otherwise the container's estimate
+    int getTotalFrames() const {
+        if (randomAccess) {
+            return index.getFrameCount();
+        }
+        return static_cast<int>(cap.get(cv::CAP_PROP_FRAME_COUNT));
+    }
+
+    const KeyframeIndex* getIndex() const {
+        return randomAccess ? &index : nullptr;
+    }
+};
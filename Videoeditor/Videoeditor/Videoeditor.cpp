@@ -9,28 +9,24 @@
 #include <thread>
 #include <filesystem>
 #include <iomanip>
-#include <windows.h>
-#include <shobjidl.h>
 #include <fstream>
 #include <map>
+#include <memory>
 #include "CursorData.h"
 #include "FileSelector.h"
 #include "CursorOverlay.h"
+#include "FrameCompositor.h"
 #include "ZoomProcessor.h"
 #include "ZoomConfig.h"
+#include "ExportPipeline.h"
+#include "RenderServer.h"
+#include "ThumbnailGenerator.h"
+#include "Trace.h"
+#include "VideoeditorApi.h"
 
 // Using declarations
 using json = nlohmann::json;
 
-// Function to convert wide string to string
-std::string wstring_to_string(const std::wstring& wstr) {
-    if (wstr.empty()) return "";
-    int size_needed = WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), NULL, 0, NULL, NULL);
-    std::string str(size_needed, 0);
-    WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), &str[0], size_needed, NULL, NULL);
-    return str;
-}
-
 // Structure to hold command-line arguments
 struct CommandLineArgs {
     std::string inputPath;
@@ -38,9 +34,19 @@ struct CommandLineArgs {
     std::string cursorDataPath;
     std::string zoomConfigPath;
     double playbackSpeed = 1.0;
-    std::string format = "16:9";
+    std::string format;
     bool showHelp = false;
     bool showVersion = false;
+    bool serve = false;
+    std::string socketPath;
+    std::string tracePath;      // Chrome trace output (--trace)
+    std::string cursorDir;      // Cursor sprite directory (--cursors)
+    std::string packCursorsDir; // Cursor pack to convert to an atlas at --output (--pack-cursors)
+    int renderFrame = -1;       // Render only this frame (--render-frame)
+    int thumbnails = 0;         // Write a thumbnail sprite sheet instead of exporting (--thumbnails)
+    int thumbnailHeight = 90;
+    bool progressJson = false;  // JSON progress lines on stdout instead of "Progress: x%"
+    int progressInterval = 30;  // Frames between progress lines
 };
 
 // Function to parse command-line arguments
@@ -51,7 +57,11 @@ CommandLineArgs parseArgs(int argc, char* argv[]) {
         {"--output", &args.outputPath},
         {"--cursor-data", &args.cursorDataPath},
         {"--zoom-config", &args.zoomConfigPath},
-        {"--format", &args.format}
+        {"--format", &args.format},
+        {"--socket", &args.socketPath},
+        {"--trace", &args.tracePath},
+        {"--cursors", &args.cursorDir},
+        {"--pack-cursors", &args.packCursorsDir}
     };
 
     for (int i = 1; i < argc; i++) {
@@ -67,6 +77,45 @@ CommandLineArgs parseArgs(int argc, char* argv[]) {
             return args;
         }
 
+        if (arg == "--serve") {
+            args.serve = true;
+            continue;
+        }
+
+        if (arg == "--render-frame") {
+            if (i + 1 < argc) {
+                try {
+                    args.renderFrame = std::stoi(argv[++i]);
+                } catch (const std::exception&) {
+                    throw std::runtime_error("Invalid value for --render-frame");
+                }
+            } else {
+                throw std::runtime_error("--render-frame requires a value");
+            }
+            continue;
+        }
+
+        if (arg == "--progress-json") {
+            args.progressJson = true;
+            continue;
+        }
+
+        if (arg == "--thumbnails" || arg == "--thumb-height" || arg == "--progress-interval") {
+            int& value = arg == "--thumbnails" ? args.thumbnails
+                       : arg == "--thumb-height" ? args.thumbnailHeight
+                       : args.progressInterval;
+            if (i + 1 < argc) {
+                try {
+                    value = std::stoi(argv[++i]);
+                } catch (const std::exception&) {
+                    throw std::runtime_error("Invalid value for " + arg);
+                }
+            } else {
+                throw std::runtime_error(arg + " requires a value");
+            }
+            continue;
+        }
+
         if (arg == "--speed") {
             if (i + 1 < argc) {
                 try {
@@ -91,9 +140,11 @@ CommandLineArgs parseArgs(int argc, char* argv[]) {
     }
 
     // Validate required arguments
-    if (!args.showHelp && !args.showVersion) {
-        if (args.inputPath.empty()) throw std::runtime_error("--input is required");
+    if (!args.showHelp && !args.showVersion && !args.serve) {
+        if (args.inputPath.empty() && args.packCursorsDir.empty()) throw std::runtime_error("--input is required");
         if (args.outputPath.empty()) throw std::runtime_error("--output is required");
+    }
+    if (!args.showHelp && !args.showVersion && !args.serve && args.thumbnails <= 0 && args.packCursorsDir.empty()) {
         if (args.cursorDataPath.empty()) throw std::runtime_error("--cursor-data is required");
         if (args.zoomConfigPath.empty()) throw std::runtime_error("--zoom-config is required");
     }
@@ -111,7 +162,17 @@ void showHelp() {
               << "  --cursor-data <path>   Cursor data JSON file path\n"
               << "  --zoom-config <path>   Zoom configuration JSON file path\n"
               << "  --speed <value>        Playback speed (default: 1.0)\n"
-              << "  --format <format>      Output format (16:9, 9:16, 1:1, gif)\n"
+              << "  --format <format>      Output aspect (16:9, 9:16, 1:1, gif; default: the recording's)\n"
+              << "  --render-frame <n>     Render only frame n to --output (.png or raw .bgra)\n"
+              << "  --thumbnails <count>   Write a keyframe thumbnail sprite sheet to --output (+ .json index)\n"
+              << "  --thumb-height <px>    Thumbnail height (default: 90)\n"
+              << "  --progress-json        Print one JSON line per progress update (fps, ETA, stage ms)\n"
+              << "  --progress-interval <n> Frames between progress updates (default: 30)\n"
+              << "  --cursors <dir|file>   Cursor sprite directory, cursor pack or .veatlas file (default: found next to the sources or executable)\n"
+              << "  --pack-cursors <dir>   Convert a cursor pack into a .veatlas file at --output\n"
+              << "  --trace <path>         Write a Chrome trace (chrome://tracing, Perfetto) of every stage\n"
+              << "  --serve                Stay resident and accept JSON-lines commands on stdin\n"
+              << "  --socket <path>        With --serve, listen on a Unix-domain socket instead\n"
               << "  --help, -h             Show this help message\n"
               << "  --version, -v          Show version information\n";
 }
@@ -121,97 +182,18 @@ void showVersion() {
     std::cout << "OpenScreen Studio Video Editor v1.0.0\n";
 }
 
-// VideoReader: Handles video file loading and frame reading
-class VideoReader {
-private:
-    cv::VideoCapture cap;
-    bool isOpen;
-    std::string lastError;
-
-public:
-    VideoReader() : isOpen(false) {}
-
-    bool open(const std::string& filename) {
-        // Check if file exists using Windows API
-        DWORD fileAttributes = GetFileAttributesA(filename.c_str());
-        if (fileAttributes == INVALID_FILE_ATTRIBUTES) {
-            lastError = "File does not exist: " + filename;
-            return false;
-        }
-
-        try {
-            isOpen = cap.open(filename);
-            if (!isOpen) {
-                lastError = "Failed to open video capture for: " + filename;
-                return false;
-            }
-
-            // Get video properties
-            double fps = cap.get(cv::CAP_PROP_FPS);
-            int width = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_WIDTH));
-            int height = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_HEIGHT));
-            int totalFrames = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_COUNT));
-
-            std::cout << "Video opened successfully:" << std::endl
-                     << "Resolution: " << width << "x" << height << std::endl
-                     << "FPS: " << fps << std::endl
-                     << "Total Frames: " << totalFrames << std::endl;
-
-            return true;
-        }
-        catch (const cv::Exception& e) {
-            lastError = "OpenCV Exception: " + std::string(e.what());
-            return false;
-        }
-        catch (const std::exception& e) {
-            lastError = "Standard Exception: " + std::string(e.what());
-            return false;
-        }
+// Cursor sprites ship next to the sources (<project>/Videoeditor/cursors, the
+// layout build.bat runs from) or are installed next to the executable
+std::string defaultCursorDir(const char* argv0) {
+    std::filesystem::path projectPath = std::filesystem::current_path().parent_path().parent_path();
+    std::filesystem::path sourceDir = projectPath / "Videoeditor" / "cursors";
+    std::error_code ec;
+    if (std::filesystem::exists(sourceDir, ec)) {
+        return sourceDir.string();
     }
-
-    bool readFrame(cv::Mat& frame) {
-        if (!isOpen) {
-            lastError = "Attempting to read from closed video";
-            return false;
-        }
-        try {
-            return cap.read(frame);
-        }
-        catch (const cv::Exception& e) {
-            lastError = "Frame reading error: " + std::string(e.what());
-            return false;
-        }
-    }
-
-    const std::string& getLastError() const {
-        return lastError;
-    }
-
-    void release() {
-        if (isOpen) {
-            cap.release();
-            isOpen = false;
-        }
-    }
-
-    bool isOpened() const { return isOpen; }
-
-    double getFPS() const {
-        return cap.get(cv::CAP_PROP_FPS);
-    }
-
-    int getWidth() const {
-        return static_cast<int>(cap.get(cv::CAP_PROP_FRAME_WIDTH));
-    }
-
-    int getHeight() const {
-        return static_cast<int>(cap.get(cv::CAP_PROP_FRAME_HEIGHT));
-    }
-
-    int getTotalFrames() const {
-        return static_cast<int>(cap.get(cv::CAP_PROP_FRAME_COUNT));
-    }
-};
+    std::filesystem::path exeDir = std::filesystem::absolute(argv0, ec).parent_path();
+    return (exeDir / "cursors").string();
+}
 
 int main(int argc, char* argv[])
 {
@@ -229,6 +211,58 @@ int main(int argc, char* argv[])
             return 0;
         }
 
+        if (!args.packCursorsDir.empty()) {
+            std::string error;
+            if (!CursorOverlay::packCursors(args.packCursorsDir, args.outputPath, error)) {
+                std::cerr << "Error: " << error << std::endl;
+                return -1;
+            }
+            std::cout << "Cursor atlas written to: " << args.outputPath << std::endl;
+            return 0;
+        }
+
+        if (args.thumbnails > 0) {
+            auto startTime = std::chrono::steady_clock::now();
+            ThumbnailOptions options;
+            options.count = args.thumbnails;
+            options.height = args.thumbnailHeight;
+            ThumbnailGenerator generator;
+            if (!generator.generate(args.inputPath, args.outputPath, options)) {
+                std::cerr << "Error: " << generator.getLastError() << std::endl;
+                return -1;
+            }
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+            json result = {{"sprite", args.outputPath},
+                           {"index", ThumbnailGenerator::getIndexPath(args.outputPath)}, {"ms", ms}};
+            std::cout << result.dump() << std::endl;
+            return 0;
+        }
+
+        // Written when main returns, after the server's workers have joined
+        TraceSession traceSession(args.tracePath);
+        Trace::setThreadName("main");
+
+        // With --progress-json stdout carries only JSON lines; logs move to stderr
+        std::unique_ptr<std::ostream> progressOut;
+        if (args.progressJson) {
+            progressOut = std::make_unique<std::ostream>(std::cout.rdbuf());
+            std::cout.rdbuf(std::cerr.rdbuf());
+        }
+
+        std::string cursorDir = args.cursorDir.empty() ? defaultCursorDir(argv[0]) : args.cursorDir;
+
+        if (args.serve) {
+            // Load sprites once; every job the server runs shares them
+            CursorOverlay cursor;
+            std::cerr << "Loading cursors from: " << cursorDir << std::endl;
+            if (!cursor.loadCursors(cursorDir)) {
+                std::cerr << "Warning: Failed to load cursor images from " << cursorDir << std::endl;
+                return -1;
+            }
+            RenderServer server(cursor);
+            return args.socketPath.empty() ? server.serveStdio() : server.serveSocket(args.socketPath);
+        }
+
         std::string videoPath;
         std::string cursorDataPath;
         std::string zoomConfigPath;
@@ -242,6 +276,10 @@ int main(int argc, char* argv[])
             outputPath = args.outputPath;
         } else {
             // Fallback to file picker mode for manual testing
+            if (!FileSelector::isAvailable()) {
+                showHelp();
+                return 1;
+            }
             std::cout << "No arguments provided, entering interactive mode...\n\n";
             
             // Select input video file
@@ -277,274 +315,101 @@ int main(int argc, char* argv[])
             }
         }
 
-        // Create instances of our classes
-        VideoReader reader;
-        ZoomProcessor processor;
-        CursorData cursorData;
-
-        // Open the input video file
-        std::cout << "\nOpening video file..." << std::endl;
-        if (!reader.open(videoPath)) {
-            std::cerr << "Error opening video: " << reader.getLastError() << std::endl;
-            return -1;
-        }
-
-        // Get video properties
-        double fps = reader.getFPS();
-        if (fps <= 0) fps = 30.0;  // Fallback to 30fps if unable to get actual FPS
-
-        // Load cursor data
-        cursorData.setVideoFPS(fps);
-        if (!cursorData.loadFromJson(cursorDataPath)) {
-            std::cerr << "Error: Failed to load cursor data from " << cursorDataPath << std::endl;
+        // Everything below goes through the same C API the editor loads in-process
+        std::cout << "Loading cursors from: " << cursorDir << std::endl;
+        std::unique_ptr<ve_engine, decltype(&ve_engine_release)> engine(
+            ve_engine_create(cursorDir.c_str()), ve_engine_release);
+        if (!engine) {
+            std::cerr << "Warning: " << ve_last_error() << std::endl;
             return -1;
         }
 
-        // Load zoom configuration
-        std::ifstream zoomFile(zoomConfigPath);
-        if (!zoomFile.is_open()) {
-            std::cerr << "Error: Could not open zoom configuration file" << std::endl;
+        std::unique_ptr<ve_project, decltype(&ve_project_release)> project(
+            ve_project_open(engine.get(), videoPath.c_str(), cursorDataPath.c_str(), zoomConfigPath.c_str(),
+                            args.format.c_str()),
+            ve_project_release);
+        if (!project) {
+            std::cerr << "Error: " << ve_last_error() << std::endl;
             return -1;
         }
 
-        json zoomJson;
-        ZoomConfig config;
-        try {
-            zoomFile >> zoomJson;
-            
-            // Parse cursor settings
-            if (zoomJson.contains("cursor")) {
-                const auto& cursor = zoomJson["cursor"];
-                config.cursor.size = cursor.value("size", 1.0);
-                config.cursor.opacity = cursor.value("opacity", 1.0);
-                config.cursor.hasTint = cursor.value("hasTint", false);
-                if (config.cursor.hasTint) {
-                    config.cursor.tintColor = cursor["tintColor"].get<uint32_t>();
-                }
-            }
-
-            // Parse background settings
-            if (zoomJson.contains("background")) {
-                const auto& bg = zoomJson["background"];
-                config.background.color = bg.value("color", 0xFF000000);
-                config.background.cornerRadius = bg.value("cornerRadius", 12.0);
-                config.background.padding = bg.value("padding", 16.0);
-                config.background.scale = bg.value("scale", 1.0);
+        if (args.renderFrame >= 0) {
+            // A single-frame render builds the keyframe index (saved next to the video)
+            // so later scrub requests seek straight to the right GOP
+            auto startTime = std::chrono::steady_clock::now();
+            ve_project_info info;
+            ve_project_get_info(project.get(), &info);
+            cv::Mat rendered(info.height, info.width, CV_8UC4);
+            if (ve_render_frame(project.get(), args.renderFrame, rendered.data,
+                                rendered.step, rendered.total() * rendered.elemSize()) != VE_OK) {
+                std::cerr << "Error: " << ve_last_error() << std::endl;
+                return -1;
             }
-
-            // Parse zoom settings
-            if (zoomJson.contains("zoom")) {
-                const auto& zoom = zoomJson["zoom"];
-                config.type = (zoom.value("type", "Manual") == "Auto") ? ZoomConfig::Type::Auto : ZoomConfig::Type::Manual;
-                
-                // Load auto layers
-                if (zoom.contains("autoLayers")) {
-                    for (const auto& layer : zoom["autoLayers"]) {
-                        AutoZoomLayer autoLayer;
-                        autoLayer.startFrame = layer.value("startFrame", 0);
-                        autoLayer.endFrame = layer.value("endFrame", 0);
-                        autoLayer.minScale = layer.value("minScale", 1.0);
-                        autoLayer.maxScale = layer.value("maxScale", 2.0);
-                        autoLayer.followSpeed = layer.value("followSpeed", 0.3);
-                        autoLayer.smoothing = layer.value("smoothing", 0.7);
-                        config.autoLayers.push_back(autoLayer);
-                    }
-                }
-                
-                // Load manual layers
-                if (zoom.contains("manualLayers")) {
-                    for (const auto& layer : zoom["manualLayers"]) {
-                        ManualZoomLayer manualLayer;
-                        manualLayer.startFrame = layer.value("startFrame", 0);
-                        manualLayer.endFrame = layer.value("endFrame", 0);
-                        manualLayer.startScale = layer.value("startScale", 1.0);
-                        manualLayer.endScale = layer.value("endScale", 2.0);
-                        manualLayer.targetX = layer.value("targetX", 0.5);
-                        manualLayer.targetY = layer.value("targetY", 0.5);
-                        config.manualLayers.push_back(manualLayer);
-                    }
-                }
-                
-                // Load defaults if present
-                if (zoom.contains("defaults")) {
-                    const auto& defaults = zoom["defaults"];
-                    config.defaults.defaultScale = defaults.value("defaultScale", 1.0);
-                    config.defaults.transitionDuration = defaults.value("transitionDuration", 0.5);
-                    config.defaults.minScale = defaults.value("minScale", 1.0);
-                    config.defaults.maxScale = defaults.value("maxScale", 2.5);
-                    config.defaults.followSpeed = defaults.value("followSpeed", 0.3);
-                    config.defaults.smoothing = defaults.value("smoothing", 0.7);
-                }
+            cv::cvtColor(rendered, rendered, cv::COLOR_BGRA2BGR);
+            std::string error;
+            if (!ExportPipeline::saveFrame(rendered, outputPath, error)) {
+                std::cerr << "Error: " << error << std::endl;
+                return -1;
             }
-            
-            processor.setConfig(config);
-            processor.setCursorData(&cursorData);
-        }
-        catch (const json::exception& e) {
-            std::cerr << "Error parsing zoom configuration: " << e.what() << std::endl;
-            return -1;
-        }
-
-        // Create output video path
-        std::filesystem::path outputVideoPath = outputPath;
-
-        // Get input video properties
-        int frameWidth = reader.getWidth();
-        int frameHeight = reader.getHeight();
-        int totalFrames = reader.getTotalFrames();
-
-        // Create video writer
-        cv::VideoWriter writer;
-        int fourcc = cv::VideoWriter::fourcc('m', 'p', '4', 'v');  // MP4 codec
-        writer.open(outputVideoPath.string(), fourcc, fps, cv::Size(frameWidth, frameHeight), true);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
 
-        if (!writer.isOpened()) {
-            std::cerr << "Error: Could not create output video file" << std::endl;
-            return -1;
+            // Last stdout line is machine-readable for the editor
+            json result = {{"frame", args.renderFrame}, {"output", outputPath},
+                           {"width", rendered.cols}, {"height", rendered.rows}, {"ms", ms}};
+            std::cout << result.dump() << std::endl;
+            return 0;
         }
 
-        // Initialize cursor overlay with proper path
-        CursorOverlay cursor;
-        std::string projectPath = std::filesystem::current_path().parent_path().parent_path().string();
-        std::string cursorDir = projectPath + "\\Videoeditor\\cursors";
-        
-        std::cout << "Loading cursors from: " << cursorDir << std::endl;
-        if (!cursor.loadCursors(cursorDir)) {
-            std::cerr << "Warning: Failed to load cursor images from " << cursorDir << std::endl;
+        std::unique_ptr<ve_export, decltype(&ve_export_release)> exportJob(
+            ve_export_start(project.get(), outputPath.c_str()), ve_export_release);
+        if (!exportJob) {
+            std::cerr << "Error: " << ve_last_error() << std::endl;
             return -1;
         }
 
-        // Apply cursor settings from zoom config
-        cursor.setSettings(config.cursor);
-
-        // Calculate optimal buffer size based on available memory
-        const size_t maxBufferMB = 512;  // Maximum 512MB buffer
-        const size_t frameSize = frameWidth * frameHeight * 3;  // 3 channels (BGR)
-        const size_t maxFramesInBuffer = (maxBufferMB * 1024 * 1024) / frameSize;
-        const size_t bufferSize = (std::min)(maxFramesInBuffer, static_cast<size_t>(30));  // Max 30 frames or memory limit
-
-        // Create frame buffers
-        std::vector<cv::Mat> frameBuffer;
-        std::vector<cv::Mat> processedBuffer;
-        frameBuffer.reserve(bufferSize);
-        processedBuffer.reserve(bufferSize);
-
-        unsigned long frameIndex = 0;
-        cv::Mat frame;
-        
-        std::cout << "\nProcessing video..." << std::endl;
-        std::cout << "Total frames to process: " << totalFrames << std::endl;
-        std::cout << "Using buffer size: " << bufferSize << " frames" << std::endl;
-
-        while (true) {
-            frameBuffer.clear();
-            processedBuffer.clear();
-
-            // Fill buffer with frames
-            for (size_t i = 0; i < bufferSize && reader.readFrame(frame); ++i) {
-                frameBuffer.push_back(frame.clone());
-            }
-
-            if (frameBuffer.empty()) {
-                break;  // End of video
-            }
-
-            // Process frames in buffer
-            for (size_t i = 0; i < frameBuffer.size(); i++) {
-                cv::Mat& currentFrame = frameBuffer[i];
-
-                // Create background with specified color
-                cv::Mat background(frameHeight, frameWidth, CV_8UC3);
-                uint8_t b = config.background.color & 0xFF;
-                uint8_t g = (config.background.color >> 8) & 0xFF;
-                uint8_t r = (config.background.color >> 16) & 0xFF;
-                background.setTo(cv::Scalar(b, g, r));
-
-                // Create a mask for rounded corners
-                cv::Mat cornerMask(frameHeight, frameWidth, CV_8UC1, cv::Scalar(0));
-                double radius = config.background.cornerRadius;
-                
-                // Draw rounded rectangle on the mask
-                cv::rectangle(cornerMask, 
-                    cv::Point(radius, 0), 
-                    cv::Point(frameWidth - radius - 1, frameHeight - 1), 
-                    cv::Scalar(255), -1);
-                cv::rectangle(cornerMask, 
-                    cv::Point(0, radius), 
-                    cv::Point(frameWidth - 1, frameHeight - radius - 1), 
-                    cv::Scalar(255), -1);
-                
-                // Draw the corner arcs
-                cv::ellipse(cornerMask, cv::Point(radius, radius), cv::Size(radius, radius), 
-                           180, 0, 90, cv::Scalar(255), -1);
-                cv::ellipse(cornerMask, cv::Point(frameWidth - radius - 1, radius), 
-                           cv::Size(radius, radius), 270, 0, 90, cv::Scalar(255), -1);
-                cv::ellipse(cornerMask, cv::Point(radius, frameHeight - radius - 1), 
-                           cv::Size(radius, radius), 90, 0, 90, cv::Scalar(255), -1);
-                cv::ellipse(cornerMask, cv::Point(frameWidth - radius - 1, frameHeight - radius - 1), 
-                           cv::Size(radius, radius), 0, 0, 90, cv::Scalar(255), -1);
-
-                // Create inverted mask for background
-                cv::Mat invertedMask;
-                cv::bitwise_not(cornerMask, invertedMask);
-
-                // Apply rounded corners by blending frame with background
-                cv::Mat roundedFrame = background.clone();
-                currentFrame.copyTo(roundedFrame, cornerMask);
-
-                // Scale down the rounded frame
-                cv::Mat scaledFrame;
-                double scale = config.background.scale;
-                int newWidth = static_cast<int>(frameWidth * scale);
-                int newHeight = static_cast<int>(frameHeight * scale);
-                cv::resize(roundedFrame, scaledFrame, cv::Size(newWidth, newHeight), 0, 0, cv::INTER_LANCZOS4);
-
-                // Create new background for scaled frame
-                cv::Mat finalBackground(frameHeight, frameWidth, CV_8UC3, cv::Scalar(b, g, r));
-
-                // Calculate position to center the scaled frame
-                int x = (frameWidth - newWidth) / 2;
-                int y = (frameHeight - newHeight) / 2;
-
-                // Create ROI in background for the scaled frame
-                cv::Mat roi = finalBackground(cv::Rect(x, y, newWidth, newHeight));
-                
-                // Copy the scaled frame to the background
-                scaledFrame.copyTo(roi);
-
-                // Get cursor position and overlay cursor
-                CursorPosition pos = cursorData.getPositionAtFrame(frameIndex + i);
-                // Adjust cursor position for scaled frame
-                int cursorX = static_cast<int>(pos.x * newWidth) + x;
-                int cursorY = static_cast<int>(pos.y * newHeight) + y;
-                cursor.overlay(finalBackground, cursorX, cursorY, pos.cursorType);
-
-                // Apply zoom effect
-                cv::Mat processedFrame;
-                processor.processFrame(finalBackground, processedFrame, frameIndex + i);
-                processedBuffer.push_back(processedFrame);
+        ProgressJsonWriter progressWriter;
+        unsigned long reportedFrames = 0;
+        int status = VE_RUNNING;
+        while (status == VE_RUNNING) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            ve_export_progress polled;
+            status = ve_export_poll(exportJob.get(), &polled);
+
+            // Report every --progress-interval frames, and the final count
+            bool finished = polled.total_frames > 0 && polled.frames_done >= static_cast<unsigned long>(polled.total_frames);
+            if (polled.frames_done == reportedFrames ||
+                (polled.frames_done < reportedFrames + args.progressInterval && !finished)) {
+                continue;
             }
-
-            // Write processed frames
-            for (const auto& processedFrame : processedBuffer) {
-                writer.write(processedFrame);
+            reportedFrames = polled.frames_done;
+
+            if (progressOut) {
+                ExportProgress progress;
+                progress.framesDone = polled.frames_done;
+                progress.totalFrames = polled.total_frames;
+                progress.elapsedSeconds = polled.elapsed_seconds;
+                progress.stages = {polled.decode_ms, polled.composite_ms, polled.cursor_ms,
+                                   polled.zoom_ms, polled.encode_ms};
+                progress.decodedQueued = polled.decoded_queued;
+                progress.decodedCapacity = polled.decoded_capacity;
+                *progressOut << progressWriter.next(progress).dump() << std::endl;
+                continue;
             }
-
-            frameIndex += frameBuffer.size();
-
             // Show progress
-            float progress = (frameIndex * 100.0f) / totalFrames;
-            std::cout << "\rProgress: " << std::fixed << std::setprecision(1) 
-                      << progress << "%" << std::flush;
+            float percent = (polled.frames_done * 100.0f) / polled.total_frames;
+            std::cout << "\rProgress: " << std::fixed << std::setprecision(1)
+                      << percent << "%" << std::flush;
+        }
+        if (status != VE_OK) {
+            std::cerr << "\nError: " << ve_last_error() << std::endl;
+            return -1;
+        }
+        if (progressOut) {
+            *progressOut << json({{"event", "done"}, {"output", outputPath}}).dump() << std::endl;
         }
 
-        // Cleanup
-        std::cout << "\nCleaning up resources..." << std::endl;
-        reader.release();
-        writer.release();
-        
         std::cout << "\nVideo processing completed successfully." << std::endl;
-        std::cout << "Output saved to: " << outputVideoPath << std::endl;
+        std::cout << "Output saved to: " << std::filesystem::path(outputPath) << std::endl;
         return 0;
     }
     catch (const std::exception& e) {
@@ -0,0 +1,266 @@
+#include "VideoeditorApi.h"
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "CursorOverlay.h"
+#include "ExportPipeline.h"
+
+static thread_local std::string lastError;
+
+static void setError(const std::string& message) {
+    lastError = message;
+}
+
+// Nothing may unwind across the C ABI (e.g. into Dart FFI), so every entry
+// point runs its body through this and turns an exception into `failure`
+template <typename Result, typename Body>
+static Result guarded(Result failure, Body body) {
+    try {
+        return body();
+    }
+    catch (const std::exception& e) {
+        setError(std::string("Unexpected error: ") + e.what());
+    }
+    catch (...) {
+        setError("Unexpected error");
+    }
+    return failure;
+}
+
+struct ve_engine {
+    CursorOverlay cursor;
+};
+
+struct ve_project {
+    ve_engine* engine;
+    Project project;
+    std::unique_ptr<ExportPipeline> pipeline;  // Kept for its compositor state between frames
+    std::mutex renderMutex;                    // One decode position per project
+    bool randomAccess = false;                 // Index built on the first ve_render_frame
+};
+
+struct ve_export {
+    std::thread worker;
+    std::atomic<bool> cancelled{false};
+    std::atomic<int> status{VE_RUNNING};
+    std::mutex progressMutex;
+    ExportProgress progress;
+    std::string error;
+};
+
+extern "C" {
+
+ve_engine* ve_engine_create(const char* cursor_dir) {
+    return guarded<ve_engine*>(nullptr, [&]() -> ve_engine* {
+        if (!cursor_dir) {
+            setError("cursor_dir is required");
+            return nullptr;
+        }
+        auto engine = std::make_unique<ve_engine>();
+        if (!engine->cursor.loadCursors(cursor_dir)) {
+            setError(std::string("Failed to load cursor images from ") + cursor_dir);
+            return nullptr;
+        }
+        return engine.release();
+    });
+}
+
+void ve_engine_release(ve_engine* engine) {
+    delete engine;
+}
+
+ve_project* ve_project_open(ve_engine* engine, const char* video_path,
+                            const char* cursor_data_path, const char* zoom_config_path,
+                            const char* format) {
+    return guarded<ve_project*>(nullptr, [&]() -> ve_project* {
+        if (!engine || !video_path || !cursor_data_path || !zoom_config_path) {
+            setError("engine, video_path, cursor_data_path and zoom_config_path are required");
+            return nullptr;
+        }
+
+        ExportJob job;
+        job.inputPath = video_path;
+        job.cursorDataPath = cursor_data_path;
+        job.zoomConfigPath = zoom_config_path;
+        job.format = format ? format : "";
+
+        auto project = std::make_unique<ve_project>();
+        project->engine = engine;
+        if (!project->project.open(job)) {
+            setError(project->project.getLastError());
+            return nullptr;
+        }
+        project->pipeline = std::make_unique<ExportPipeline>(engine->cursor);
+        return project.release();
+    });
+}
+
+int ve_project_get_info(ve_project* project, ve_project_info* info) {
+    return guarded<int>(VE_ERROR, [&]() -> int {
+        if (!project || !info) {
+            setError("project and info are required");
+            return VE_ERROR;
+        }
+        info->width = project->project.layout.canvasSize.width;
+        info->height = project->project.layout.canvasSize.height;
+        info->fps = project->project.fps;
+        info->frame_count = project->project.reader.getTotalFrames();
+        return VE_OK;
+    });
+}
+
+void ve_project_release(ve_project* project) {
+    delete project;
+}
+
+int ve_render_frame(ve_project* project, int frame_index,
+                    unsigned char* bgra, size_t stride, size_t buffer_size) {
+    return guarded<int>(VE_ERROR, [&]() -> int {
+        if (!project || !bgra) {
+            setError("project and bgra are required");
+            return VE_ERROR;
+        }
+        std::lock_guard<std::mutex> lock(project->renderMutex);
+
+        int frameCount = project->project.reader.getTotalFrames();
+        if (frame_index < 0 || frame_index >= frameCount) {
+            setError("frame_index " + std::to_string(frame_index) + " is outside 0.." + std::to_string(frameCount - 1));
+            return VE_ERROR;
+        }
+
+        int width = project->project.layout.canvasSize.width;
+        int height = project->project.layout.canvasSize.height;
+        if (stride < static_cast<size_t>(width) * 4 || buffer_size < stride * height) {
+            setError("Buffer too small for " + std::to_string(width) + "x" + std::to_string(height) + " BGRA");
+            return VE_BUFFER_TOO_SMALL;
+        }
+
+        // Exports decode sequentially with their own reader, so only pay for the
+        // keyframe index once frames are actually requested out of order
+        if (!project->randomAccess) {
+            if (!project->project.reader.enableRandomAccess()) {
+                std::cerr << "Keyframe index unavailable, seeking without it" << std::endl;
+            }
+            project->randomAccess = true;
+        }
+
+        cv::Mat frame;
+        if (!project->pipeline->renderFrame(project->project, frame_index, frame)) {
+            setError(project->pipeline->getLastError());
+            return VE_ERROR;
+        }
+
+        // Convert straight into the caller's memory
+        cv::Mat target(height, width, CV_8UC4, bgra, stride);
+        cv::cvtColor(frame, target, cv::COLOR_BGR2BGRA);
+        return VE_OK;
+    });
+}
+
+ve_export* ve_export_start(ve_project* project, const char* output_path) {
+    return guarded<ve_export*>(nullptr, [&]() -> ve_export* {
+        if (!project || !output_path) {
+            setError("project and output_path are required");
+            return nullptr;
+        }
+
+        auto job = std::make_unique<ve_export>();
+        ve_export* state = job.get();
+        ExportJob exportJob = project->project.job;
+        exportJob.outputPath = output_path;
+        CursorOverlay cursor = project->engine->cursor;  // Sprites share pixel data
+
+        // The export decodes with its own reader so previews keep working meanwhile
+        state->worker = std::thread([state, exportJob, cursor]() {
+            // An exception here would call std::terminate; report it through poll instead
+            try {
+                Project exportProject;
+                if (!exportProject.open(exportJob)) {
+                    std::lock_guard<std::mutex> lock(state->progressMutex);
+                    state->error = exportProject.getLastError();
+                    state->status = VE_ERROR;
+                    return;
+                }
+
+                ExportPipeline pipeline(cursor);
+                pipeline.setProgressInterval(1);
+                bool ok = pipeline.run(exportProject, exportJob.outputPath, &state->cancelled,
+                    [state](const ExportProgress& progress) {
+                        std::lock_guard<std::mutex> lock(state->progressMutex);
+                        state->progress = progress;
+                    });
+
+                std::lock_guard<std::mutex> lock(state->progressMutex);
+                if (ok) {
+                    state->status = VE_OK;
+                } else if (state->cancelled.load()) {
+                    state->status = VE_CANCELLED;
+                } else {
+                    state->error = pipeline.getLastError();
+                    state->status = VE_ERROR;
+                }
+            }
+            catch (const std::exception& e) {
+                std::lock_guard<std::mutex> lock(state->progressMutex);
+                state->error = std::string("Export failed: ") + e.what();
+                state->status = VE_ERROR;
+            }
+    });
+    return job.release();
+    });
+}
+
+int ve_export_poll(ve_export* job, ve_export_progress* progress) {
+    return guarded<int>(VE_ERROR, [&]() -> int {
+        if (!job) {
+            setError("job is required");
+            return VE_ERROR;
+        }
+        std::lock_guard<std::mutex> lock(job->progressMutex);
+        if (progress) {
+            const ExportProgress& p = job->progress;
+            progress->frames_done = p.framesDone;
+            progress->total_frames = p.totalFrames;
+            progress->elapsed_seconds = p.elapsedSeconds;
+            progress->decode_ms = p.stages.decode;
+            progress->composite_ms = p.stages.composite;
+            progress->cursor_ms = p.stages.cursor;
+            progress->zoom_ms = p.stages.zoom;
+            progress->encode_ms = p.stages.encode;
+            progress->decoded_queued = p.decodedQueued;
+            progress->decoded_capacity = p.decodedCapacity;
+        }
+        int status = job->status.load();
+        if (status == VE_ERROR) {
+            setError(job->error);
+        }
+        return status;
+    });
+}
+
+void ve_export_cancel(ve_export* job) {
+    if (job) {
+        job->cancelled.store(true);
+    }
+}
+
+void ve_export_release(ve_export* job) {
+    if (!job) return;
+    job->cancelled.store(true);
+    guarded<int>(VE_ERROR, [&]() -> int {
+        if (job->worker.joinable()) {
+            job->worker.join();
+        }
+        return VE_OK;
+    });
+    delete job;
+}
+
+const char* ve_last_error(void) {
+    return lastError.c_str();
+}
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <stddef.h>
+
+// C ABI of the render engine, for in-process use (Dart FFI) without spawning
+// Videoeditor.exe. The CLI is a thin wrapper around these same calls.
+//
+// Typical use:
+//   ve_engine* engine = ve_engine_create(cursorDir);          // Cursors rasterized once
+//   ve_project* project = ve_project_open(engine, video, cursorJson, zoomJson, "16:9");
+//   ve_project_get_info(project, &info);
+//   ve_render_frame(project, 120, pixels, info.width * 4, bufferSize);
+//   ve_export* job = ve_export_start(project, "out.mp4");
+//   while (ve_export_poll(job, &progress) == VE_RUNNING) { ... }
+//   ve_export_release(job); ve_project_release(project); ve_engine_release(engine);
+//
+// Functions returning a pointer return NULL on failure, functions returning
+// int return a ve_status; ve_last_error() then describes the failure on the
+// calling thread. An engine must outlive its projects, and a project its exports.
+
+#if defined(VIDEOEDITOR_SHARED)
+#  if defined(_WIN32)
+#    define VE_API __declspec(dllexport)
+#  else
+#    define VE_API __attribute__((visibility("default")))
+#  endif
+#else
+#  define VE_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ve_engine ve_engine;
+typedef struct ve_project ve_project;
+typedef struct ve_export ve_export;
+
+enum ve_status {
+    VE_OK = 0,
+    VE_ERROR = 1,
+    VE_BUFFER_TOO_SMALL = 2,
+    VE_RUNNING = 3,     // ve_export_poll: still exporting
+    VE_CANCELLED = 4    // ve_export_poll: stopped by ve_export_cancel, output removed
+};
+
+typedef struct ve_project_info {
+    int width;          // Output frame size (depends on the format)
+    int height;
+    double fps;
+    int frame_count;
+} ve_project_info;
+
+typedef struct ve_export_progress {
+    unsigned long frames_done;
+    int total_frames;
+    double elapsed_seconds;
+    // Milliseconds spent per stage so far
+    double decode_ms;
+    double composite_ms;
+    double cursor_ms;
+    double zoom_ms;
+    double encode_ms;
+    size_t decoded_queued;      // Frames decoded but not yet composited
+    size_t decoded_capacity;
+} ve_export_progress;
+
+// Loads and rasterizes the cursor sprites shared by everything the engine renders
+VE_API ve_engine* ve_engine_create(const char* cursor_dir);
+VE_API void ve_engine_release(ve_engine* engine);
+
+// Opens a recording with its cursor track and zoom configuration. format is
+// the output aspect ("16:9", "9:16", "1:1", ...; NULL keeps the recording's).
+// The first ve_render_frame builds the keyframe index so later frames seek directly.
+VE_API ve_project* ve_project_open(ve_engine* engine, const char* video_path,
+                                   const char* cursor_data_path, const char* zoom_config_path,
+                                   const char* format);
+VE_API int ve_project_get_info(ve_project* project, ve_project_info* info);
+VE_API void ve_project_release(ve_project* project);
+
+// Renders one output frame as BGRA into a caller-owned buffer of
+// buffer_size bytes with rows stride bytes apart (at least width * 4).
+// frame_index must be in 0..frame_count-1, otherwise VE_ERROR.
+VE_API int ve_render_frame(ve_project* project, int frame_index,
+                           unsigned char* bgra, size_t stride, size_t buffer_size);
+
+// Starts exporting the project to output_path on a background thread
+VE_API ve_export* ve_export_start(ve_project* project, const char* output_path);
+// Fills progress (may be NULL) and returns VE_RUNNING, VE_OK, VE_CANCELLED or VE_ERROR
+VE_API int ve_export_poll(ve_export* job, ve_export_progress* progress);
+VE_API void ve_export_cancel(ve_export* job);
+// Cancels the export if it is still running and waits for it to stop
+VE_API void ve_export_release(ve_export* job);
+
+// Description of the last failure on the calling thread ("" if none). No
+// function lets a C++ exception escape; one is reported as VE_ERROR (or NULL).
+VE_API const char* ve_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -2,6 +2,8 @@
 #include <vector>
 #include <optional>
 #include <cstdint>
+#include <string>
+#include "Easing.h"
 
 // Cursor settings structure
 struct CursorSettings {
@@ -9,14 +11,61 @@ struct CursorSettings {
     double opacity = 1.0;       // Opacity (0.1 to 1.0)
     uint32_t tintColor = 0;     // Color in ARGB format (0 for default)
     bool hasTint = false;       // Whether tint should be applied
+
+    // Cursor path smoothing, evaluated once into a per-frame table
+    enum class Smoothing {
+        None,        // Linear interpolation of the raw samples
+        OneEuro,     // Adaptive low-pass: steady at rest, responsive when moving fast
+        CatmullRom   // Centripetal spline through the samples
+    };
+    Smoothing smoothing = Smoothing::None;
+    double minCutoff = 1.0;     // One-Euro cutoff at rest, Hz
+    double beta = 7.0;          // One-Euro cutoff increase per normalized unit/s of speed
+
+    bool motionBlur = false;            // Blur the cursor along fast moves
+    int motionBlurSamples = 6;          // Sub-frame positions averaged
+    double motionBlurThreshold = 12.0;  // Pixels per frame below which the cursor is drawn sharp
+};
+
+// Soft shadow under the video card
+struct ShadowSettings {
+    bool enabled = false;
+    double offsetX = 0.0;          // Pixels
+    double offsetY = 12.0;
+    double blur = 32.0;            // Blur radius in pixels (Gaussian sigma is half of it)
+    double opacity = 0.4;          // 0 to 1
+    uint32_t color = 0xFF000000;   // Color in ARGB format
 };
 
 // Background settings structure
 struct BackgroundSettings {
+    enum class Type {
+        Solid,
+        LinearGradient,   // color -> gradientColor along gradientAngle
+        RadialGradient,   // color at the centre -> gradientColor at the corners
+        Image,            // imagePath, scaled to cover the output
+        BlurredFrame      // The recording itself, blurred, behind the video
+    };
+
+    Type type = Type::Solid;
     uint32_t color = 0xFF000000;  // Color in ARGB format
+    uint32_t gradientColor = 0xFF000000;  // Second gradient stop, ARGB
+    double gradientAngle = 135.0;  // Degrees, 0 = left to right, 90 = top to bottom
+    std::string imagePath;
+    double frameBlur = 48.0;       // Blur radius of BlurredFrame in output pixels
+    int frameBlurInterval = 6;     // Frames between BlurredFrame refreshes
     double cornerRadius = 12.0;    // Rounded corner radius in pixels
     double padding = 16.0;         // Padding around the video in pixels
     double scale = 1.0;           // Scale factor for the video frame
+    ShadowSettings shadow;
+};
+
+// Cutting of idle stretches (still cursor and unchanging screen) from the export
+struct TrimSettings {
+    bool enabled = false;
+    double minIdleSeconds = 3.0;   // Shorter idle stretches are kept
+    double keepSeconds = 0.5;      // Kept at each end of a cut so it does not feel abrupt
+    double threshold = 0.002;      // Largest mean frame change (0-1) still counted as idle
 };
 
 struct ZoomPoint {
@@ -32,6 +81,8 @@ struct ManualZoomLayer {
     double endScale;
     double targetX;     // Fixed target X (0-1)
     double targetY;     // Fixed target Y (0-1)
+    std::optional<double> transitionDuration;  // Seconds; defaults.transitionDuration if unset
+    std::optional<EasingCurve> easing;         // defaults.easing if unset
 };
 
 struct AutoZoomLayer {
@@ -41,6 +92,8 @@ struct AutoZoomLayer {
     double maxScale;    // Maximum zoom scale
     double followSpeed; // How quickly to follow the cursor (0-1)
     double smoothing;   // Smoothing factor for cursor movement (0-1)
+    std::optional<double> transitionDuration;  // Seconds; defaults.transitionDuration if unset
+    std::optional<EasingCurve> easing;         // defaults.easing if unset
 };
 
 struct ZoomConfig {
@@ -52,11 +105,13 @@ struct ZoomConfig {
     Type type;
     std::vector<ManualZoomLayer> manualLayers;
     std::vector<AutoZoomLayer> autoLayers;
+    bool generateLayers = false;  // Add layers for clicks, dwells and typing found in the cursor track
     
     // Default values for auto-zoom
     struct {
         double defaultScale = 1.0;
         double transitionDuration = 0.5;  // seconds
+        EasingCurve easing;               // Curve of zoom-in/out transitions
         double minScale = 1.0;
         double maxScale = 2.5;
         double followSpeed = 0.3;
@@ -66,6 +121,8 @@ struct ZoomConfig {
     // New settings
     CursorSettings cursor;
     BackgroundSettings background;
+    TrimSettings trim;
+    bool analyzeActivity = false;  // Track on-screen activity beside decode (Project::activity)
 
     // Helper function to find active layer at a given frame
     std::optional<ManualZoomLayer> getActiveManualLayer(int frameIndex) const {
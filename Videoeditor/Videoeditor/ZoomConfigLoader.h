@@ -0,0 +1,161 @@
+#pragma once
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <nlohmann/json.hpp>
+#include "ZoomConfig.h"
+
+// Parses the zoom configuration JSON written by the Flutter editor
+class ZoomConfigLoader {
+public:
+    static bool loadFromJson(const std::string& jsonPath, ZoomConfig& config, std::string& error) {
+        std::ifstream zoomFile(jsonPath);
+        if (!zoomFile.is_open()) {
+            error = "Could not open zoom configuration file: " + jsonPath;
+            return false;
+        }
+
+        try {
+            nlohmann::json zoomJson;
+            zoomFile >> zoomJson;
+            parse(zoomJson, config);
+            return true;
+        }
+        catch (const nlohmann::json::exception& e) {
+            error = "Error parsing zoom configuration: " + std::string(e.what());
+            return false;
+        }
+    }
+
+    // Unknown curves fall back to the default ease-in-out rather than failing the export
+    static EasingCurve parseEasing(const std::string& text) {
+        EasingCurve curve;
+        if (!EasingCurve::parse(text, curve)) {
+            std::cerr << "Warning: unknown easing \"" << text << "\", using ease-in-out-quad" << std::endl;
+            curve = EasingCurve();
+        }
+        return curve;
+    }
+
+    static void parseTransition(const nlohmann::json& layer, std::optional<double>& duration,
+                                std::optional<EasingCurve>& easing) {
+        if (layer.contains("transitionDuration")) {
+            duration = layer["transitionDuration"].get<double>();
+        }
+        if (layer.contains("easing")) {
+            easing = parseEasing(layer["easing"].get<std::string>());
+        }
+    }
+
+    static void parse(const nlohmann::json& zoomJson, ZoomConfig& config) {
+        // Parse cursor settings
+        if (zoomJson.contains("cursor")) {
+            const auto& cursor = zoomJson["cursor"];
+            config.cursor.size = cursor.value("size", 1.0);
+            config.cursor.opacity = cursor.value("opacity", 1.0);
+            config.cursor.hasTint = cursor.value("hasTint", false);
+            if (config.cursor.hasTint) {
+                config.cursor.tintColor = cursor["tintColor"].get<uint32_t>();
+            }
+            std::string smoothing = cursor.value("smoothing", "none");
+            if (smoothing == "one-euro") config.cursor.smoothing = CursorSettings::Smoothing::OneEuro;
+            else if (smoothing == "catmull-rom") config.cursor.smoothing = CursorSettings::Smoothing::CatmullRom;
+            else config.cursor.smoothing = CursorSettings::Smoothing::None;
+            config.cursor.minCutoff = cursor.value("minCutoff", 1.0);
+            config.cursor.beta = cursor.value("beta", 7.0);
+            config.cursor.motionBlur = cursor.value("motionBlur", false);
+            config.cursor.motionBlurSamples = cursor.value("motionBlurSamples", 6);
+            config.cursor.motionBlurThreshold = cursor.value("motionBlurThreshold", 12.0);
+        }
+
+        // Parse background settings
+        if (zoomJson.contains("background")) {
+            const auto& bg = zoomJson["background"];
+            std::string type = bg.value("type", "solid");
+            if (type == "linear") config.background.type = BackgroundSettings::Type::LinearGradient;
+            else if (type == "radial") config.background.type = BackgroundSettings::Type::RadialGradient;
+            else if (type == "image") config.background.type = BackgroundSettings::Type::Image;
+            else if (type == "blurred") config.background.type = BackgroundSettings::Type::BlurredFrame;
+            else config.background.type = BackgroundSettings::Type::Solid;
+            config.background.color = bg.value("color", 0xFF000000);
+            config.background.gradientColor = bg.value("gradientColor", config.background.color);
+            config.background.gradientAngle = bg.value("gradientAngle", 135.0);
+            config.background.imagePath = bg.value("image", "");
+            config.background.frameBlur = bg.value("frameBlur", 48.0);
+            config.background.frameBlurInterval = bg.value("frameBlurInterval", 6);
+            config.background.cornerRadius = bg.value("cornerRadius", 12.0);
+            config.background.padding = bg.value("padding", 16.0);
+            config.background.scale = bg.value("scale", 1.0);
+            if (bg.contains("shadow")) {
+                const auto& shadow = bg["shadow"];
+                config.background.shadow.enabled = shadow.value("enabled", true);
+                config.background.shadow.offsetX = shadow.value("offsetX", 0.0);
+                config.background.shadow.offsetY = shadow.value("offsetY", 12.0);
+                config.background.shadow.blur = shadow.value("blur", 32.0);
+                config.background.shadow.opacity = shadow.value("opacity", 0.4);
+                config.background.shadow.color = shadow.value("color", 0xFF000000);
+            }
+        }
+
+        // Parse idle trimming
+        if (zoomJson.contains("trim")) {
+            const auto& trim = zoomJson["trim"];
+            config.trim.enabled = trim.value("enabled", true);
+            config.trim.minIdleSeconds = trim.value("minIdleSeconds", 3.0);
+            config.trim.keepSeconds = trim.value("keepSeconds", 0.5);
+            config.trim.threshold = trim.value("threshold", 0.002);
+        }
+
+        config.analyzeActivity = zoomJson.value("analyzeActivity", false);
+
+        // Parse zoom settings
+        if (zoomJson.contains("zoom")) {
+            const auto& zoom = zoomJson["zoom"];
+            config.type = (zoom.value("type", "Manual") == "Auto") ? ZoomConfig::Type::Auto : ZoomConfig::Type::Manual;
+            config.generateLayers = zoom.value("generateLayers", false);
+
+            // Load auto layers
+            if (zoom.contains("autoLayers")) {
+                for (const auto& layer : zoom["autoLayers"]) {
+                    AutoZoomLayer autoLayer;
+                    autoLayer.startFrame = layer.value("startFrame", 0);
+                    autoLayer.endFrame = layer.value("endFrame", 0);
+                    autoLayer.minScale = layer.value("minScale", 1.0);
+                    autoLayer.maxScale = layer.value("maxScale", 2.0);
+                    autoLayer.followSpeed = layer.value("followSpeed", 0.3);
+                    autoLayer.smoothing = layer.value("smoothing", 0.7);
+                    parseTransition(layer, autoLayer.transitionDuration, autoLayer.easing);
+                    config.autoLayers.push_back(autoLayer);
+                }
+            }
+
+            // Load manual layers
+            if (zoom.contains("manualLayers")) {
+                for (const auto& layer : zoom["manualLayers"]) {
+                    ManualZoomLayer manualLayer;
+                    manualLayer.startFrame = layer.value("startFrame", 0);
+                    manualLayer.endFrame = layer.value("endFrame", 0);
+                    manualLayer.startScale = layer.value("startScale", 1.0);
+                    manualLayer.endScale = layer.value("endScale", 2.0);
+                    manualLayer.targetX = layer.value("targetX", 0.5);
+                    manualLayer.targetY = layer.value("targetY", 0.5);
+                    parseTransition(layer, manualLayer.transitionDuration, manualLayer.easing);
+                    config.manualLayers.push_back(manualLayer);
+                }
+            }
+
+            // Load defaults if present
+            if (zoom.contains("defaults")) {
+                const auto& defaults = zoom["defaults"];
+                config.defaults.defaultScale = defaults.value("defaultScale", 1.0);
+                config.defaults.transitionDuration = defaults.value("transitionDuration", 0.5);
+                config.defaults.easing = parseEasing(defaults.value("easing", ""));
+                config.defaults.minScale = defaults.value("minScale", 1.0);
+                config.defaults.maxScale = defaults.value("maxScale", 2.5);
+                config.defaults.followSpeed = defaults.value("followSpeed", 0.3);
+                config.defaults.smoothing = defaults.value("smoothing", 0.7);
+            }
+        }
+    }
+};
@@ -0,0 +1,150 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "ZoomConfig.h"
+#include "CursorData.h"
+#include "Easing.h"
+#include "AutoZoomPlanner.h"
+
+// Zoom scale and target for every frame of a project, computed once up front.
+// Auto-zoom camera paths are planned over the whole cursor track, so evaluating
+// them ahead of time is what lets a single frame be rendered on its own.
+class ZoomPlan {
+private:
+    std::vector<ZoomState> states;
+
+    // Transition curve of each layer, sampled at the project's frame rate so
+    // transitions last the same time at any fps
+    std::vector<EasingTable> manualTransitions;
+    std::vector<EasingTable> autoTransitions;
+
+    // Camera path of each auto layer, indexed from the layer's start frame
+    std::vector<std::vector<ZoomState>> autoPlans;
+
+    template <typename Layer>
+    static EasingTable transitionTable(const Layer& layer, const ZoomConfig& config, double fps) {
+        double seconds = layer.transitionDuration.value_or(config.defaults.transitionDuration);
+        EasingTable table;
+        table.build(layer.easing.value_or(config.defaults.easing),
+                    static_cast<int>(std::lround((std::max)(seconds, 0.0) * fps)));
+        return table;
+    }
+
+    // Index of the first layer covering the frame, or -1
+    template <typename Layer>
+    static int activeLayer(const std::vector<Layer>& layers, long frameIndex) {
+        for (size_t i = 0; i < layers.size(); ++i) {
+            if (frameIndex >= layers[i].startFrame && frameIndex <= layers[i].endFrame) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    // Resolves the zoom scale and target for a frame from the active layer
+    void calculateTransform(const ZoomConfig& config, long frameIndex,
+                            double& scale, double& targetX, double& targetY) {
+        // Handle manual zoom layers
+        int manualIndex = activeLayer(config.manualLayers, frameIndex);
+        int autoIndex = manualIndex < 0 ? activeLayer(config.autoLayers, frameIndex) : -1;
+        if (manualIndex >= 0) {
+            const ManualZoomLayer* manualLayer = &config.manualLayers[manualIndex];
+            const EasingTable& transition = manualTransitions[manualIndex];
+            int transitionFrames = transition.frames();
+
+            // Apply ease-in at start and ease-out at end
+            if (frameIndex <= manualLayer->startFrame + transitionFrames) {
+                // Ease in
+                scale = 1.0 + (manualLayer->startScale - 1.0) * transition.at(frameIndex - manualLayer->startFrame);
+            }
+            else if (frameIndex >= manualLayer->endFrame - transitionFrames) {
+                // Ease out
+                scale = manualLayer->endScale + (1.0 - manualLayer->endScale) *
+                        (1.0 - transition.at(manualLayer->endFrame - frameIndex));
+            }
+            else {
+                // Full zoom during middle of layer
+                scale = manualLayer->startScale;
+            }
+
+            targetX = manualLayer->targetX;
+            targetY = manualLayer->targetY;
+        }
+        // Handle auto zoom layers
+        else if (autoIndex >= 0) {
+            const std::vector<ZoomState>& plan = autoPlans[autoIndex];
+            long offset = frameIndex - config.autoLayers[autoIndex].startFrame;
+            if (offset < static_cast<long>(plan.size())) {
+                calculateAutoZoom(config.autoLayers[autoIndex], autoTransitions[autoIndex], plan[offset],
+                                  scale, targetX, targetY, frameIndex);
+            }
+        }
+    }
+
+    // Applies the layer's enter and exit transitions to its planned camera
+    void calculateAutoZoom(const AutoZoomLayer& layer, const EasingTable& transition,
+                         const ZoomState& planned,
+                         double& outScale, double& outTargetX, double& outTargetY,
+                         long frameIndex) {
+        int transitionFrames = transition.frames();
+
+        // Apply transitions at layer boundaries
+        if (frameIndex <= layer.startFrame + transitionFrames) {
+            // Ease in from scale 1.0
+            double t = transition.at(frameIndex - layer.startFrame);
+            outScale = 1.0 + (planned.scale - 1.0) * t;
+            outTargetX = 0.5 + (planned.targetX - 0.5) * t;
+            outTargetY = 0.5 + (planned.targetY - 0.5) * t;
+        }
+        else if (frameIndex >= layer.endFrame - transitionFrames) {
+            // Ease out to scale 1.0
+            double t = transition.at(layer.endFrame - frameIndex);
+            outScale = planned.scale + (1.0 - planned.scale) * (1.0 - t);
+            outTargetX = planned.targetX + (0.5 - planned.targetX) * (1.0 - t);
+            outTargetY = planned.targetY + (0.5 - planned.targetY) * (1.0 - t);
+        }
+        else {
+            // Normal auto-zoom behavior
+            outScale = planned.scale;
+            outTargetX = planned.targetX;
+            outTargetY = planned.targetY;
+        }
+    }
+
+public:
+    void build(const ZoomConfig& config, const CursorData* cursorData, int frameCount, double fps) {
+        manualTransitions.clear();
+        for (const auto& layer : config.manualLayers) {
+            manualTransitions.push_back(transitionTable(layer, config, fps));
+        }
+        autoTransitions.clear();
+        for (const auto& layer : config.autoLayers) {
+            autoTransitions.push_back(transitionTable(layer, config, fps));
+        }
+
+        // Only the part of each layer inside the recording is planned
+        autoPlans.clear();
+        for (const auto& layer : config.autoLayers) {
+            AutoZoomLayer clipped = layer;
+            clipped.endFrame = (std::min)(layer.endFrame, frameCount - 1);
+            autoPlans.push_back(cursorData ? AutoZoomPlanner::plan(clipped, *cursorData, fps)
+                                           : std::vector<ZoomState>());
+        }
+
+        states.assign((std::max)(frameCount, 0), ZoomState());
+        for (int i = 0; i < frameCount; i++) {
+            ZoomState& state = states[i];
+            calculateTransform(config, i, state.scale, state.targetX, state.targetY);
+        }
+    }
+
+    // Frames past the end of the plan (e.g. an inaccurate frame count) stay unzoomed
+    ZoomState at(unsigned long frameIndex) const {
+        return frameIndex < states.size() ? states[frameIndex] : ZoomState();
+    }
+
+    size_t size() const {
+        return states.size();
+    }
+};
@@ -1,154 +1,97 @@
 #pragma once
 #include <opencv2/opencv.hpp>
-#include "ZoomConfig.h"
-#include "CursorData.h"
+#include <vector>
+#include "ZoomPlan.h"
+#include "Trace.h"
 
 class ZoomProcessor {
 private:
     cv::Size originalSize;
     bool firstFrame;
-    ZoomConfig config;
-    CursorData* cursorData;  // Pointer to cursor data for auto-zoom
-    const int TRANSITION_FRAMES = 30;  // Number of frames for transitions
-
-    // Smoothing for auto-zoom
-    struct {
-        double lastX = 0.5;
-        double lastY = 0.5;
-        double lastScale = 1.0;
-    } smoothedValues;
-
-    // Helper function for smooth interpolation
-    double smoothValue(double current, double target, double smoothing) {
-        return current + (target - current) * (1.0 - smoothing);
-    }
-
-    // Helper function for ease in-out interpolation
-    double easeInOutQuad(double t) {
-        return t < 0.5 ? 2 * t * t : 1 - pow(-2 * t + 2, 2) / 2;
+    const ZoomPlan* plan;  // Precomputed zoom per frame, owned by the project
+
+    // Crop of the virtually zoomed frame that ends up in the output
+    struct ZoomTransform {
+        int zoomedWidth = 0;
+        int zoomedHeight = 0;
+        int cropX = 0;
+        int cropY = 0;
+
+        bool operator==(const ZoomTransform& other) const {
+            return zoomedWidth == other.zoomedWidth && zoomedHeight == other.zoomedHeight &&
+                   cropX == other.cropX && cropY == other.cropY;
+        }
+    };
+
+    ZoomTransform lastTransform;
+    cv::Mat lastOutput;
+    bool hasLastOutput;
+
+    // Output region whose pixels depend on the given input region
+    cv::Rect mapToOutput(const cv::Rect& inputRect) const {
+        double sx = static_cast<double>(lastTransform.zoomedWidth) / originalSize.width;
+        double sy = static_cast<double>(lastTransform.zoomedHeight) / originalSize.height;
+        int x0 = static_cast<int>(std::floor(inputRect.x * sx)) - lastTransform.cropX - 2;
+        int y0 = static_cast<int>(std::floor(inputRect.y * sy)) - lastTransform.cropY - 2;
+        int x1 = static_cast<int>(std::ceil((inputRect.x + inputRect.width) * sx)) - lastTransform.cropX + 2;
+        int y1 = static_cast<int>(std::ceil((inputRect.y + inputRect.height) * sy)) - lastTransform.cropY + 2;
+        return cv::Rect(cv::Point(x0, y0), cv::Point(x1, y1)) & cv::Rect(cv::Point(0, 0), originalSize);
     }
 
-    // Calculate auto-zoom parameters based on cursor position
-    void calculateAutoZoom(const AutoZoomLayer& layer, const CursorPosition& cursorPos,
-                         double& outScale, double& outTargetX, double& outTargetY,
-                         unsigned long frameIndex) {
-        // Calculate transition progress for start and end
-        double startTransition = static_cast<double>(frameIndex - layer.startFrame) / TRANSITION_FRAMES;
-        double endTransition = static_cast<double>(layer.endFrame - frameIndex) / TRANSITION_FRAMES;
-        
-        startTransition = std::clamp(startTransition, 0.0, 1.0);
-        endTransition = std::clamp(endTransition, 0.0, 1.0);
-
-        // Smooth the target position
-        smoothedValues.lastX = smoothValue(smoothedValues.lastX, cursorPos.x, layer.smoothing);
-        smoothedValues.lastY = smoothValue(smoothedValues.lastY, cursorPos.y, layer.smoothing);
-
-        // Calculate distance from center to determine scale
-        double dx = smoothedValues.lastX - 0.5;
-        double dy = smoothedValues.lastY - 0.5;
-        double distanceFromCenter = std::sqrt(dx * dx + dy * dy);
-
-        // Scale based on distance from center
-        double targetScale = layer.minScale + 
-            (layer.maxScale - layer.minScale) * (1.0 - distanceFromCenter);
-        targetScale = std::clamp(targetScale, layer.minScale, layer.maxScale);
-
-        // Smooth the scale
-        smoothedValues.lastScale = smoothValue(smoothedValues.lastScale, targetScale, layer.smoothing);
-
-        // Apply transitions at layer boundaries
-        if (frameIndex <= layer.startFrame + TRANSITION_FRAMES) {
-            // Ease in from scale 1.0
-            double t = easeInOutQuad(startTransition);
-            outScale = 1.0 + (smoothedValues.lastScale - 1.0) * t;
-            outTargetX = 0.5 + (smoothedValues.lastX - 0.5) * t;
-            outTargetY = 0.5 + (smoothedValues.lastY - 0.5) * t;
-        }
-        else if (frameIndex >= layer.endFrame - TRANSITION_FRAMES) {
-            // Ease out to scale 1.0
-            double t = easeInOutQuad(endTransition);
-            outScale = smoothedValues.lastScale + (1.0 - smoothedValues.lastScale) * (1.0 - t);
-            outTargetX = smoothedValues.lastX + (0.5 - smoothedValues.lastX) * (1.0 - t);
-            outTargetY = smoothedValues.lastY + (0.5 - smoothedValues.lastY) * (1.0 - t);
-        }
-        else {
-            // Normal auto-zoom behavior
-            outScale = smoothedValues.lastScale;
-            outTargetX = smoothedValues.lastX;
-            outTargetY = smoothedValues.lastY;
+    // Renders one output region straight from the input, equivalent to resizing
+    // the whole frame to the zoomed size and cropping, without the full resize
+    void warpRegion(const cv::Mat& input, const cv::Rect& outputRect) {
+        if (outputRect.empty()) return;
+        TRACE_SCOPE("zoomWarp");
+        cv::Mat dst = lastOutput(outputRect);
+
+        if (lastTransform.zoomedWidth == originalSize.width &&
+            lastTransform.zoomedHeight == originalSize.height) {
+            input(outputRect).copyTo(dst);
+            return;
         }
+
+        double ax = static_cast<double>(originalSize.width) / lastTransform.zoomedWidth;
+        double ay = static_cast<double>(originalSize.height) / lastTransform.zoomedHeight;
+        cv::Matx23d inverse(
+            ax, 0, (outputRect.x + lastTransform.cropX + 0.5) * ax - 0.5,
+            0, ay, (outputRect.y + lastTransform.cropY + 0.5) * ay - 0.5);
+        cv::warpAffine(input, dst, cv::Mat(inverse), outputRect.size(),
+                       cv::INTER_LINEAR | cv::WARP_INVERSE_MAP, cv::BORDER_REPLICATE);
     }
 
 public:
-    ZoomProcessor() : firstFrame(true), cursorData(nullptr) {}
+    ZoomProcessor() : firstFrame(true), plan(nullptr), hasLastOutput(false) {}
 
-    void setCursorData(CursorData* data) {
-        cursorData = data;
+    void setPlan(const ZoomPlan* zoomPlan) {
+        plan = zoomPlan;
+        hasLastOutput = false;
     }
 
-    void setConfig(const ZoomConfig& newConfig) {
-        config = newConfig;
-        // Reset smoothing values
-        smoothedValues = {0.5, 0.5, 1.0};
+    void processFrame(const cv::Mat& input, cv::Mat& output, unsigned long frameIndex) {
+        processFrame(input, output, frameIndex, nullptr);
     }
 
-    void processFrame(const cv::Mat& input, cv::Mat& output, unsigned long frameIndex) {
+    // Region-aware variant: when the zoom transform matches the previous frame and
+    // dirtyRegions lists every input region that changed, only those regions are
+    // re-warped into the previous output. Output shares the processor's buffer.
+    void processFrame(const cv::Mat& input, cv::Mat& output, unsigned long frameIndex,
+                      const std::vector<cv::Rect>* dirtyRegions) {
+        TRACE_SCOPE("ZoomProcessor::processFrame");
         if (firstFrame) {
             originalSize = input.size();
             firstFrame = false;
         }
 
-        double scale = 1.0;
-        double targetX = 0.5;
-        double targetY = 0.5;
-
-        // Handle manual zoom layers
-        if (auto manualLayer = config.getActiveManualLayer(frameIndex)) {
-            // Calculate base progress through the layer
-            double progress = static_cast<double>(frameIndex - manualLayer->startFrame) /
-                            (manualLayer->endFrame - manualLayer->startFrame);
-            progress = std::clamp(progress, 0.0, 1.0);
-
-            // Calculate transition progress for start and end
-            double startTransition = static_cast<double>(frameIndex - manualLayer->startFrame) / TRANSITION_FRAMES;
-            double endTransition = static_cast<double>(manualLayer->endFrame - frameIndex) / TRANSITION_FRAMES;
-            
-            startTransition = std::clamp(startTransition, 0.0, 1.0);
-            endTransition = std::clamp(endTransition, 0.0, 1.0);
-
-            // Apply ease-in at start and ease-out at end
-            if (frameIndex <= manualLayer->startFrame + TRANSITION_FRAMES) {
-                // Ease in
-                scale = 1.0 + (manualLayer->startScale - 1.0) * easeInOutQuad(startTransition);
-            }
-            else if (frameIndex >= manualLayer->endFrame - TRANSITION_FRAMES) {
-                // Ease out
-                scale = manualLayer->endScale + (1.0 - manualLayer->endScale) * (1.0 - easeInOutQuad(endTransition));
-            }
-            else {
-                // Full zoom during middle of layer
-                scale = manualLayer->startScale;
-            }
-
-            targetX = manualLayer->targetX;
-            targetY = manualLayer->targetY;
-        }
-        // Handle auto zoom layers
-        else if (auto autoLayer = config.getActiveAutoLayer(frameIndex)) {
-            if (cursorData) {
-                CursorPosition cursorPos = cursorData->getPositionAtFrame(frameIndex);
-                calculateAutoZoom(*autoLayer, cursorPos, scale, targetX, targetY, frameIndex);
-            }
-        }
+        ZoomState state = plan ? plan->at(frameIndex) : ZoomState();
+        double scale = state.scale;
+        double targetX = state.targetX;
+        double targetY = state.targetY;
 
         // Apply zoom effect
         int newWidth = static_cast<int>(originalSize.width * scale);
         int newHeight = static_cast<int>(originalSize.height * scale);
 
-        // Create zoomed version of the frame
-        cv::Mat zoomed;
-        cv::resize(input, zoomed, cv::Size(newWidth, newHeight), 0, 0, cv::INTER_LINEAR);
-
         // Calculate crop region
         int x = static_cast<int>((newWidth - originalSize.width) * targetX);
         int y = static_cast<int>((newHeight - originalSize.height) * targetY);
@@ -157,8 +100,20 @@ public:
         x = std::clamp(x, 0, newWidth - originalSize.width);
         y = std::clamp(y, 0, newHeight - originalSize.height);
 
-        // Crop the region
-        cv::Rect roi(x, y, originalSize.width, originalSize.height);
-        output = zoomed(roi).clone();
+        ZoomTransform transform{newWidth, newHeight, x, y};
+        bool canReuse = dirtyRegions && hasLastOutput && transform == lastTransform &&
+                        lastOutput.size() == originalSize;
+        lastTransform = transform;
+
+        if (!canReuse) {
+            lastOutput.create(originalSize, input.type());
+            warpRegion(input, cv::Rect(cv::Point(0, 0), originalSize));
+            hasLastOutput = true;
+        } else {
+            for (const auto& region : *dirtyRegions) {
+                warpRegion(input, mapToOutput(region));
+            }
+        }
+        output = lastOutput;
     }
 }; 
\ No newline at end of file
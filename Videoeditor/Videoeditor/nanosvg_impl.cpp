@@ -0,0 +1,10 @@
+// Compiles the nanosvg parser and rasterizer exactly once for the whole program.
+// Every other file includes the headers without the implementation defines.
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+
+#define NANOSVG_IMPLEMENTATION
+#define NANOSVGRAST_IMPLEMENTATION
+#include "nanosvg/nanosvg.h"
+#include "nanosvg/nanosvgrast.h"
@@ -0,0 +1,504 @@
+// Benchmark.cpp : Export benchmarks on deterministic synthetic recordings.
+//
+//   Benchmark.exe generate <dir> [--width w] [--height h] [--seconds s] [--fps f]
+//   Benchmark.exe micro [--cursors <dir>] [--csv results.csv] [--label <commit>]
+//   Benchmark.exe e2e   [--cursors <dir>] [--csv results.csv] [--label <commit>] [--keep <dir>]
+//   Benchmark.exe all   (micro + e2e, the default)
+//
+// Results are printed and appended to the CSV (one row per benchmark), so runs
+// on different commits can be compared side by side.
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "SyntheticRecording.h"
+#include "../Videoeditor/CursorData.h"
+#include "../Videoeditor/CursorEvents.h"
+#include "../Videoeditor/CursorOverlay.h"
+#include "../Videoeditor/CursorSmoother.h"
+#include "../Videoeditor/ExportPipeline.h"
+#include "../Videoeditor/BackgroundLayer.h"
+#include "../Videoeditor/FrameCompositor.h"
+#include "../Videoeditor/FrameLayout.h"
+#include "../Videoeditor/ScreenActivity.h"
+#include "../Videoeditor/ThumbnailGenerator.h"
+#include "../Videoeditor/ZoomConfigLoader.h"
+#include "../Videoeditor/ZoomPlan.h"
+#include "../Videoeditor/ZoomProcessor.h"
+
+struct BenchmarkArgs {
+    std::string command = "all";
+    std::string directory;
+    std::string cursorDir = "Videoeditor/cursors";
+    std::string csvPath = "benchmark_results.csv";
+    std::string label;
+    std::string keepDir;
+    SyntheticRecording::Options recording;
+};
+
+struct BenchmarkResult {
+    std::string name;
+    std::string resolution;
+    int iterations = 0;
+    double totalMs = 0;
+    double medianMs = 0;
+    double fps = 0;
+    std::string notes;
+};
+
+// Runs fn iterations times after a short warm-up and records the median and total
+static BenchmarkResult measure(const std::string& name, int iterations, const std::function<void(int)>& fn) {
+    for (int i = 0; i < (std::min)(iterations, 5); i++) {
+        fn(i);
+    }
+
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    for (int i = 0; i < iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        fn(i);
+        samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    BenchmarkResult result;
+    result.name = name;
+    result.iterations = iterations;
+    for (double sample : samples) result.totalMs += sample;
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    result.medianMs = samples[samples.size() / 2];
+    result.fps = result.totalMs > 0 ? iterations * 1000.0 / result.totalMs : 0;
+    return result;
+}
+
+static void printResult(const BenchmarkResult& result) {
+    std::cout << std::left << std::setw(34) << result.name
+              << std::right << std::setw(10) << result.resolution
+              << std::setw(8) << result.iterations
+              << std::setw(12) << std::fixed << std::setprecision(3) << result.medianMs << " ms"
+              << std::setw(12) << std::setprecision(1) << result.fps << " /s"
+              << (result.notes.empty() ? "" : "  " + result.notes) << std::endl;
+}
+
+static bool appendCsv(const std::string& path, const std::string& label, const std::vector<BenchmarkResult>& results) {
+    bool exists = std::filesystem::exists(path);
+    std::ofstream file(path, std::ios::app);
+    if (!file.is_open()) {
+        std::cerr << "Could not write " << path << std::endl;
+        return false;
+    }
+    if (!exists) {
+        file << "timestamp,label,benchmark,resolution,iterations,total_ms,median_ms,per_second,notes\n";
+    }
+
+    std::time_t now = std::time(nullptr);
+    char timestamp[32];
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    for (const auto& r : results) {
+        file << timestamp << ',' << label << ',' << r.name << ',' << r.resolution << ','
+             << r.iterations << ',' << r.totalMs << ',' << r.medianMs << ',' << r.fps << ",\"" << r.notes << "\"\n";
+    }
+    return true;
+}
+
+static std::string resolutionOf(const SyntheticRecording::Options& options) {
+    return std::to_string(options.width) + "x" + std::to_string(options.height);
+}
+
+// Synthetic frames are rendered up front so generation is not part of the timing
+static std::vector<cv::Mat> renderFrames(const SyntheticRecording& recording, int count) {
+    std::vector<cv::Mat> frames(count);
+    for (int i = 0; i < count; i++) {
+        recording.renderFrame(i, frames[i]);
+    }
+    return frames;
+}
+
+static std::vector<BenchmarkResult> runMicro(const BenchmarkArgs& args) {
+    std::vector<BenchmarkResult> results;
+    SyntheticRecording recording(args.recording);
+    std::string resolution = resolutionOf(args.recording);
+    int frameCount = (std::min)(recording.frameCount(), 300);
+    std::vector<cv::Mat> frames = renderFrames(recording, frameCount);
+
+    ZoomConfig config;
+    ZoomConfigLoader::parse(recording.zoomJson(), config);
+
+    std::filesystem::path temp = std::filesystem::temp_directory_path() / "videoeditor_bench_micro";
+    std::filesystem::create_directories(temp);
+    std::string cursorPath = (temp / "cursor.json").string();
+    {
+        std::ofstream file(cursorPath);
+        file << recording.cursorJson().dump();
+    }
+    CursorData cursorData;
+    cursorData.setVideoFPS(args.recording.fps);
+    cursorData.loadFromJson(cursorPath);
+
+    // CursorData loading
+    {
+        BenchmarkResult r = measure("CursorData::loadFromJson", 20, [&](int) {
+            CursorData data;
+            data.loadFromJson(cursorPath);
+        });
+        r.resolution = "-";
+        r.notes = std::to_string(recording.frameCount()) + " positions";
+        results.push_back(r);
+    }
+
+    // Per-frame cursor table, built once when a project opens
+    {
+        CursorSettings smoothed = config.cursor;
+        smoothed.smoothing = CursorSettings::Smoothing::OneEuro;
+        BenchmarkResult r = measure("CursorSmoother::buildFrameTable one-euro", 200, [&](int) {
+            CursorSmoother::buildFrameTable(cursorData, smoothed, recording.frameCount(), args.recording.fps);
+        });
+        r.resolution = "-";
+        r.notes = std::to_string(recording.frameCount()) + " frames";
+        results.push_back(r);
+    }
+
+    // Click/dwell/typing index and layer generation, one pass over the track
+    {
+        BenchmarkResult r = measure("CursorEventIndex build + generateLayers", 200, [&](int) {
+            CursorEventIndex events;
+            events.build(cursorData);
+            ZoomConfig generated = config;
+            events.generateLayers(generated, args.recording.fps, recording.frameCount());
+        });
+        r.resolution = "-";
+        r.notes = std::to_string(recording.frameCount()) + " positions";
+        results.push_back(r);
+    }
+
+    CursorOverlay cursor;
+    bool haveCursors = cursor.loadCursors(args.cursorDir);
+    if (!haveCursors) {
+        std::cerr << "Cursor sprites not found in " << args.cursorDir
+                  << "; cursor benchmarks measure the no-sprite path" << std::endl;
+    }
+    cursor.setSettings(config.cursor);
+
+    // Process start: find the cursor files, map the cached atlas (built by the
+    // warm-up runs) and cut the sprites of the types the recording uses
+    if (haveCursors) {
+        std::vector<int> types = cursorData.getCursorTypes();
+        BenchmarkResult r = measure("CursorOverlay load + prepare", 20, [&](int) {
+            CursorOverlay cold;
+            cold.loadCursors(args.cursorDir);
+            cold.setSettings(config.cursor);
+            cold.prepare(types);
+        });
+        r.resolution = "-";
+        r.notes = std::to_string(types.size()) + " cursor types, cached atlas";
+        results.push_back(r);
+    }
+
+    // CursorOverlay::overlay on a moving cursor
+    {
+        cv::Mat canvas = frames[0].clone();
+        BenchmarkResult r = measure("CursorOverlay::overlay", 2000, [&](int i) {
+            CursorPosition pos = cursorData.getPositionAtFrame(i % frameCount);
+            cursor.overlay(canvas, pos.x * canvas.cols, pos.y * canvas.rows,
+                           pos.cursorType);
+        });
+        r.resolution = resolution;
+        results.push_back(r);
+    }
+    {
+        CursorOverlay blurring = cursor;
+        CursorSettings blurSettings = config.cursor;
+        blurSettings.motionBlur = true;
+        blurring.setSettings(blurSettings);
+        cv::Mat canvas = frames[0].clone();
+        BenchmarkResult r = measure("CursorOverlay::overlayMotion", 2000, [&](int i) {
+            cv::Point2d from((i * 37) % canvas.cols, canvas.rows / 2);
+            blurring.overlayMotion(canvas, from, from + cv::Point2d(60, 20), 65539);
+        });
+        r.resolution = resolution;
+        r.notes = std::to_string(blurSettings.motionBlurSamples) + " samples, 63 px/frame";
+        results.push_back(r);
+    }
+
+    // Compositor: full recompose (settings reset) vs. incremental frame to frame
+    FrameLayout layout = FrameLayout::compute(frames[0].size(), config.background, 0);
+    {
+        FrameCompositor compositor;
+        compositor.setSettings(config.background, layout);
+        BenchmarkResult r = measure("FrameCompositor::compose full", 100, [&](int i) {
+            compositor.setSettings(config.background, layout);
+            compositor.compose(frames[i % frameCount], cursor, cursorData.getPositionAtFrame(i % frameCount));
+        });
+        r.resolution = resolution;
+        r.notes = "rounded corners + scale";
+        results.push_back(r);
+    }
+    {
+        FrameCompositor compositor;
+        compositor.setSettings(config.background, layout);
+        BenchmarkResult r = measure("FrameCompositor::compose sequence", frameCount, [&](int i) {
+            compositor.compose(frames[i], cursor, cursorData.getPositionAtFrame(i));
+        });
+        r.resolution = resolution;
+        r.notes = "typing/scroll/idle mix";
+        results.push_back(r);
+    }
+
+    // Blurred-frame background refresh (1/8 resolution blur + shadow)
+    {
+        BackgroundSettings blurred = config.background;
+        blurred.type = BackgroundSettings::Type::BlurredFrame;
+        FrameLayout blurredLayout = FrameLayout::compute(frames[0].size(), blurred, 0);
+        BackgroundLayer layer;
+        BenchmarkResult r = measure("BackgroundLayer::render blurred", 100, [&](int i) {
+            layer.render(blurred, blurredLayout, frames[i % frameCount]);
+        });
+        r.resolution = resolution;
+        results.push_back(r);
+    }
+
+    // Screen activity per frame; e2e reports it as a share of decode
+    {
+        ActivityAnalyzer activity;
+        BenchmarkResult r = measure("ActivityAnalyzer::analyze", frameCount, [&](int i) {
+            activity.analyze(frames[i]);
+        });
+        r.resolution = resolution;
+        r.notes = "1/8 scale gray diff + heatmap";
+        results.push_back(r);
+    }
+
+    // ZoomProcessor: full warp at a zoomed frame, and the dirty-region path
+    {
+        ZoomPlan plan;
+        plan.build(config, &cursorData, recording.frameCount(), recording.getOptions().fps);
+        ZoomProcessor processor;
+        processor.setPlan(&plan);
+        cv::Mat output;
+        BenchmarkResult r = measure("ZoomProcessor::processFrame", frameCount, [&](int i) {
+            processor.processFrame(frames[i], output, i);
+        });
+        r.resolution = resolution;
+        results.push_back(r);
+
+        FrameCompositor compositor;
+        compositor.setSettings(config.background, layout);
+        ZoomProcessor incremental;
+        incremental.setPlan(&plan);
+        BenchmarkResult dirty = measure("ZoomProcessor::processFrame dirty", frameCount, [&](int i) {
+            const cv::Mat& composited = compositor.compose(frames[i], cursor, cursorData.getPositionAtFrame(i));
+            incremental.processFrame(composited, output, i, &compositor.getDirtyRects());
+        });
+        dirty.resolution = resolution;
+        dirty.notes = "includes compose";
+        results.push_back(dirty);
+    }
+
+    std::error_code ignored;
+    std::filesystem::remove_all(temp, ignored);
+    return results;
+}
+
+static std::vector<BenchmarkResult> runEndToEnd(const BenchmarkArgs& args) {
+    std::vector<BenchmarkResult> results;
+    SyntheticRecording recording(args.recording);
+
+    std::filesystem::path dir = args.keepDir.empty()
+        ? std::filesystem::temp_directory_path() / "videoeditor_bench_e2e"
+        : std::filesystem::path(args.keepDir);
+    std::string error;
+    if (!recording.write(dir.string(), error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return results;
+    }
+
+    CursorOverlay cursor;
+    if (!cursor.loadCursors(args.cursorDir)) {
+        std::cerr << "Cursor sprites not found in " << args.cursorDir << std::endl;
+    }
+
+    ExportJob job;
+    job.inputPath = (dir / "recording.mp4").string();
+    job.outputPath = (dir / "export.mp4").string();
+    job.cursorDataPath = (dir / "cursor.json").string();
+    job.zoomConfigPath = (dir / "zoom.json").string();
+
+    Project project;
+    if (!project.open(job)) {
+        std::cerr << "Error: " << project.getLastError() << std::endl;
+        return results;
+    }
+
+    ExportPipeline pipeline(cursor);
+    ExportProgress last;
+    auto start = std::chrono::steady_clock::now();
+    bool ok = pipeline.run(project, job.outputPath, nullptr, [&](const ExportProgress& progress) {
+        last = progress;
+    });
+    double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (!ok) {
+        std::cerr << "Error: " << pipeline.getLastError() << std::endl;
+        return results;
+    }
+
+    BenchmarkResult r;
+    r.name = "export end-to-end";
+    r.resolution = resolutionOf(args.recording);
+    r.iterations = static_cast<int>(last.framesDone);
+    r.totalMs = totalMs;
+    r.medianMs = last.framesDone ? totalMs / last.framesDone : 0;
+    r.fps = totalMs > 0 ? last.framesDone * 1000.0 / totalMs : 0;
+    std::ostringstream notes;
+    notes << std::fixed << std::setprecision(1)
+          << "decode=" << last.stages.decode << " composite=" << last.stages.composite
+          << " cursor=" << last.stages.cursor << " zoom=" << last.stages.zoom
+          << " encode=" << last.stages.encode << " ms";
+    r.notes = notes.str();
+    results.push_back(r);
+
+    // Activity analysis against the decode it runs beside (config.analyzeActivity);
+    // the budget is 5% of decode
+    {
+        VideoReader reader;
+        if (reader.open(job.inputPath)) {
+            ActivityAnalyzer activity;
+            double decodeMs = 0, analyzeMs = 0;
+            int frames = 0;
+            cv::Mat frame;
+            while (true) {
+                auto t0 = std::chrono::steady_clock::now();
+                if (!reader.readFrame(frame)) break;
+                auto t1 = std::chrono::steady_clock::now();
+                activity.analyze(frame);
+                auto t2 = std::chrono::steady_clock::now();
+                decodeMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+                analyzeMs += std::chrono::duration<double, std::milli>(t2 - t1).count();
+                frames++;
+            }
+            BenchmarkResult activityResult;
+            activityResult.name = "ActivityAnalyzer vs decode";
+            activityResult.resolution = r.resolution;
+            activityResult.iterations = frames;
+            activityResult.totalMs = analyzeMs;
+            activityResult.medianMs = frames ? analyzeMs / frames : 0;
+            activityResult.fps = analyzeMs > 0 ? frames * 1000.0 / analyzeMs : 0;
+            std::ostringstream activityNotes;
+            activityNotes << std::fixed << std::setprecision(1)
+                          << (decodeMs > 0 ? 100.0 * analyzeMs / decodeMs : 0) << "% of decode";
+            activityResult.notes = activityNotes.str();
+            results.push_back(activityResult);
+        }
+    }
+
+    // Filmstrip cost, in frames of the sequential decode measured above:
+    // every thumbnail seeks, and the backend decodes forward from a keyframe
+    {
+        ThumbnailOptions options;
+        options.count = 20;
+        ThumbnailGenerator generator;
+        auto thumbStart = std::chrono::steady_clock::now();
+        if (generator.generate(job.inputPath, (dir / "strip.jpg").string(), options)) {
+            double thumbMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - thumbStart).count();
+            double decodeMs = last.framesDone ? last.stages.decode / last.framesDone : 0;
+            BenchmarkResult thumbs;
+            thumbs.name = "ThumbnailGenerator::generate";
+            thumbs.resolution = r.resolution;
+            thumbs.iterations = options.count;
+            thumbs.totalMs = thumbMs;
+            thumbs.medianMs = thumbMs / options.count;
+            thumbs.fps = thumbMs > 0 ? options.count * 1000.0 / thumbMs : 0;
+            std::ostringstream thumbNotes;
+            thumbNotes << std::fixed << std::setprecision(1)
+                       << (decodeMs > 0 ? thumbs.medianMs / decodeMs : 0) << " decoded frames/thumbnail";
+            thumbs.notes = thumbNotes.str();
+            results.push_back(thumbs);
+        } else {
+            std::cerr << "Error: " << generator.getLastError() << std::endl;
+        }
+    }
+
+    project.reader.release();
+    if (args.keepDir.empty()) {
+        std::error_code ignored;
+        std::filesystem::remove_all(dir, ignored);
+    }
+    return results;
+}
+
+static BenchmarkArgs parseArgs(int argc, char* argv[]) {
+    BenchmarkArgs args;
+    int i = 1;
+    if (i < argc && argv[i][0] != '-') {
+        args.command = argv[i++];
+        if (args.command == "generate") {
+            if (i >= argc) throw std::runtime_error("generate requires a directory");
+            args.directory = argv[i++];
+        }
+    }
+    for (; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) throw std::runtime_error(arg + " requires a value");
+        std::string value = argv[++i];
+        if (arg == "--width") args.recording.width = std::stoi(value);
+        else if (arg == "--height") args.recording.height = std::stoi(value);
+        else if (arg == "--seconds") args.recording.seconds = std::stod(value);
+        else if (arg == "--fps") args.recording.fps = std::stod(value);
+        else if (arg == "--seed") args.recording.seed = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--cursors") args.cursorDir = value;
+        else if (arg == "--csv") args.csvPath = value;
+        else if (arg == "--label") args.label = value;
+        else if (arg == "--keep") args.keepDir = value;
+        else throw std::runtime_error("Unknown option: " + arg);
+    }
+    return args;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        BenchmarkArgs args = parseArgs(argc, argv);
+
+        if (args.command == "generate") {
+            std::string error;
+            if (!SyntheticRecording(args.recording).write(args.directory, error)) {
+                std::cerr << "Error: " << error << std::endl;
+                return 1;
+            }
+            std::cout << "Wrote recording.mp4, cursor.json and zoom.json to " << args.directory << std::endl;
+            return 0;
+        }
+
+        // Library logging would interleave with the result table
+        std::streambuf* stdoutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+        std::vector<BenchmarkResult> results;
+        if (args.command == "micro" || args.command == "all") {
+            auto micro = runMicro(args);
+            results.insert(results.end(), micro.begin(), micro.end());
+        }
+        if (args.command == "e2e" || args.command == "all") {
+            auto e2e = runEndToEnd(args);
+            results.insert(results.end(), e2e.begin(), e2e.end());
+        }
+        std::cout.rdbuf(stdoutBuffer);
+
+        if (results.empty()) {
+            std::cerr << "No benchmarks ran (command: " << args.command << ")" << std::endl;
+            return 1;
+        }
+        for (const auto& result : results) {
+            printResult(result);
+        }
+        return appendCsv(args.csvPath, args.label, results) ? 0 : 1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
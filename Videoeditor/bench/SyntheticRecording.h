@@ -0,0 +1,262 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+struct SyntheticRecordingOptions {
+    int width = 1920;
+    int height = 1080;
+    double fps = 30.0;
+    double seconds = 10.0;
+    uint32_t seed = 1;
+};
+
+// Deterministic stand-in for a screen recording: a document with text-like
+// lines where a paragraph is typed, the page scrolls and then sits idle, in a
+// repeating cycle, plus the matching cursor track and zoom configuration.
+//
+// Every frame is a pure function of its index and the options, so benchmarks
+// and the golden-frame tests can render any frame without decoding video.
+// Randomness uses raw std::mt19937 output (portable) rather than the standard
+// distributions (implementation-defined).
+class SyntheticRecording {
+public:
+    using Options = SyntheticRecordingOptions;
+
+    // Phases of each CYCLE_SECONDS cycle
+    enum class Phase { Typing, Scrolling, Idle };
+
+private:
+    Options options;
+    cv::Mat page;                    // Whole document, taller than one screen
+    struct Word { int line; int x; int width; };
+    std::vector<Word> words;         // In reading order
+    std::vector<int> lineFirstWord;  // Index of the first word on each line
+    int lineHeight;
+    int margin;
+    int toolbarHeight;
+
+    static constexpr double CYCLE_SECONDS = 10.0;
+    static constexpr double TYPING_END = 3.0;     // Seconds into the cycle
+    static constexpr double SCROLL_END = 6.0;
+    static constexpr int WORDS_PER_SECOND = 8;
+    static constexpr int SCROLL_PIXELS_PER_SECOND = 180;
+    inline static const cv::Scalar PAPER = cv::Scalar(250, 250, 250);
+    inline static const cv::Scalar INK = cv::Scalar(40, 40, 40);
+
+    double cycleTime(int frameIndex, int& cycle) const {
+        double t = frameIndex / options.fps;
+        cycle = static_cast<int>(t / CYCLE_SECONDS);
+        return t - cycle * CYCLE_SECONDS;
+    }
+
+    // Scroll offset into the page at the start of a cycle's typing phase
+    int scrollAtCycle(int cycle) const {
+        int perCycle = static_cast<int>((SCROLL_END - TYPING_END) * SCROLL_PIXELS_PER_SECOND);
+        int maxScroll = page.rows - (options.height - toolbarHeight);
+        return maxScroll > 0 ? (cycle * perCycle) % maxScroll : 0;
+    }
+
+    int scrollAt(int frameIndex) const {
+        int cycle;
+        double t = cycleTime(frameIndex, cycle);
+        int base = scrollAtCycle(cycle);
+        if (t < TYPING_END) return base;
+        double scrolled = ((std::min)(t, SCROLL_END) - TYPING_END) * SCROLL_PIXELS_PER_SECOND;
+        int maxScroll = page.rows - (options.height - toolbarHeight);
+        return (std::min)(base + static_cast<int>(scrolled), (std::max)(0, maxScroll));
+    }
+
+    // First word typed in a cycle: the paragraph in the middle of the viewport
+    int typingStartWord(int cycle) const {
+        int viewLines = (options.height - toolbarHeight) / lineHeight;
+        int line = (std::min)(scrollAtCycle(cycle) / lineHeight + viewLines / 2,
+                              static_cast<int>(lineFirstWord.size()) - 1);
+        return lineFirstWord[line];
+    }
+
+    // Index one past the last word typed so far; words beyond it on screen are
+    // still blank. Outside the typing phase the whole page is written.
+    int typedUntil(int frameIndex) const {
+        int cycle;
+        double t = cycleTime(frameIndex, cycle);
+        if (t >= TYPING_END) return static_cast<int>(words.size());
+        int typed = static_cast<int>(t * WORDS_PER_SECOND) + 1;
+        return (std::min)(typingStartWord(cycle) + typed, static_cast<int>(words.size()));
+    }
+
+    cv::Rect wordRect(const Word& word) const {
+        return cv::Rect(word.x, word.line * lineHeight + lineHeight / 4, word.width, lineHeight / 2);
+    }
+
+    void buildPage() {
+        lineHeight = (std::max)(12, options.height / 40);
+        margin = options.width / 12;
+        toolbarHeight = lineHeight * 2;
+        int lines = (options.height * 3) / lineHeight;
+        page = cv::Mat(lines * lineHeight, options.width, CV_8UC3, PAPER);
+
+        // Lay out words line by line
+        std::mt19937 rng(options.seed);
+        words.clear();
+        lineFirstWord.clear();
+        for (int line = 0; line < lines; line++) {
+            lineFirstWord.push_back(static_cast<int>(words.size()));
+            int x = margin;
+            int lineEnd = options.width - margin - static_cast<int>(rng() % (options.width / 4));
+            while (true) {
+                int width = lineHeight + static_cast<int>(rng() % (lineHeight * 4));
+                if (x + width > lineEnd) break;
+                words.push_back({line, x, width});
+                page(wordRect(words.back())).setTo(INK);
+                x += width + lineHeight / 2;
+            }
+        }
+    }
+
+public:
+    explicit SyntheticRecording(const Options& recordingOptions = Options()) : options(recordingOptions) {
+        buildPage();
+    }
+
+    const Options& getOptions() const {
+        return options;
+    }
+
+    int frameCount() const {
+        return static_cast<int>(std::lround(options.seconds * options.fps));
+    }
+
+    Phase phaseAt(int frameIndex) const {
+        int cycle;
+        double t = cycleTime(frameIndex, cycle);
+        if (t < TYPING_END) return Phase::Typing;
+        if (t < SCROLL_END) return Phase::Scrolling;
+        return Phase::Idle;
+    }
+
+    void renderFrame(int frameIndex, cv::Mat& frame) const {
+        frame.create(options.height, options.width, CV_8UC3);
+
+        // Toolbar
+        frame(cv::Rect(0, 0, options.width, toolbarHeight)).setTo(cv::Scalar(60, 60, 60));
+        for (int i = 0; i < 6; i++) {
+            cv::rectangle(frame, cv::Rect(margin / 4 + i * toolbarHeight, toolbarHeight / 4,
+                                          toolbarHeight / 2, toolbarHeight / 2),
+                          cv::Scalar(200, 200, 200), cv::FILLED);
+        }
+
+        // Document viewport, with the words not typed yet blanked out
+        int scroll = scrollAt(frameIndex);
+        int viewHeight = options.height - toolbarHeight;
+        cv::Mat view = frame(cv::Rect(0, toolbarHeight, options.width, viewHeight));
+        page(cv::Rect(0, scroll, options.width, viewHeight)).copyTo(view);
+
+        int lastLine = (scroll + viewHeight) / lineHeight;
+        for (size_t i = typedUntil(frameIndex); i < words.size() && words[i].line <= lastLine; i++) {
+            cv::Rect rect = (wordRect(words[i]) - cv::Point(0, scroll)) & cv::Rect(0, 0, options.width, viewHeight);
+            if (!rect.empty()) {
+                view(rect).setTo(PAPER);
+            }
+        }
+    }
+
+    // Cursor in normalized coordinates: follows the typing caret, drifts to the
+    // scrollbar while scrolling, and rests while idle
+    nlohmann::json cursorAt(int frameIndex) const {
+        int64_t timestamp = static_cast<int64_t>(std::lround(frameIndex * 1000.0 / options.fps));
+        double x = 0.5;
+        double y = 0.5;
+        int cursorType = 65539;  // Arrow
+
+        switch (phaseAt(frameIndex)) {
+            case Phase::Typing: {
+                const Word& word = words[typedUntil(frameIndex) - 1];
+                int scroll = scrollAt(frameIndex);
+                x = static_cast<double>(word.x + word.width) / options.width;
+                y = static_cast<double>(toolbarHeight + word.line * lineHeight - scroll + lineHeight / 2) / options.height;
+                cursorType = 65541;  // I-beam
+                break;
+            }
+            case Phase::Scrolling:
+                x = 0.98;
+                y = 0.5 + 0.2 * std::sin(frameIndex * 0.05);
+                break;
+            case Phase::Idle:
+                x = 0.6;
+                y = 0.55;
+                break;
+        }
+        x = std::clamp(x, 0.0, 1.0);
+        y = std::clamp(y, 0.0, 1.0);
+        return {{"x", x}, {"y", y}, {"timestamp", timestamp}, {"cursorType", cursorType}};
+    }
+
+    nlohmann::json cursorJson() const {
+        nlohmann::json positions = nlohmann::json::array();
+        for (int i = 0; i < frameCount(); i++) {
+            positions.push_back(cursorAt(i));
+        }
+        return {{"positions", positions}};
+    }
+
+    // One manual zoom on the first typing burst and an auto-zoom layer over the
+    // rest, so both zoom paths are exercised
+    nlohmann::json zoomJson() const {
+        int frames = frameCount();
+        int typingFrames = static_cast<int>(TYPING_END * options.fps);
+        return {
+            {"cursor", {{"size", 1.0}, {"opacity", 1.0}, {"hasTint", false}}},
+            {"background", {{"color", 0xFF1E1E2E}, {"cornerRadius", 12.0}, {"padding", 16.0}, {"scale", 0.9},
+                            {"shadow", {{"offsetY", 12.0}, {"blur", 32.0}, {"opacity", 0.4}}}}},
+            {"zoom", {
+                {"type", "Manual"},
+                {"manualLayers", nlohmann::json::array({
+                    {{"startFrame", 0}, {"endFrame", typingFrames}, {"startScale", 1.0},
+                     {"endScale", 1.8}, {"targetX", 0.4}, {"targetY", 0.3}}})},
+                {"autoLayers", nlohmann::json::array({
+                    {{"startFrame", typingFrames + 1}, {"endFrame", frames - 1}, {"minScale", 1.0},
+                     {"maxScale", 2.0}, {"followSpeed", 0.3}, {"smoothing", 0.7}}})},
+                {"defaults", {{"defaultScale", 1.0}, {"transitionDuration", 0.5}}}
+            }}
+        };
+    }
+
+    // Writes recording.mp4, cursor.json and zoom.json into directory
+    bool write(const std::string& directory, std::string& error) const {
+        std::filesystem::path dir(directory);
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+
+        cv::VideoWriter writer;
+        writer.open((dir / "recording.mp4").string(), cv::VideoWriter::fourcc('m', 'p', '4', 'v'),
+                    options.fps, cv::Size(options.width, options.height), true);
+        if (!writer.isOpened()) {
+            error = "Could not create " + (dir / "recording.mp4").string();
+            return false;
+        }
+        cv::Mat frame;
+        for (int i = 0; i < frameCount(); i++) {
+            renderFrame(i, frame);
+            writer.write(frame);
+        }
+        writer.release();
+
+        std::ofstream cursorFile(dir / "cursor.json");
+        std::ofstream zoomFile(dir / "zoom.json");
+        if (!cursorFile.is_open() || !zoomFile.is_open()) {
+            error = "Could not write fixture JSON in " + dir.string();
+            return false;
+        }
+        cursorFile << cursorJson().dump();
+        zoomFile << zoomJson().dump(2);
+        return true;
+    }
+};
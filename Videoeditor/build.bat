@@ -5,6 +5,10 @@ setlocal enabledelayedexpansion
 set BUILD_TYPE=Debug
 if not "%1"=="" set BUILD_TYPE=%1
 
+:: Optional second argument selects the target: Videoeditor (default), engine, bench or tests
+set TARGET=Videoeditor
+if not "%2"=="" set TARGET=%2
+
 :: Configuration
 set OPENCV_DIR=C:\Program Files\opencv
 set OPENCV_VERSION=4100
@@ -49,6 +53,10 @@ if /I "%BUILD_TYPE%"=="Debug" (
     set OPENCV_SUFFIX=
 )
 
+if /I "%TARGET%"=="engine" goto build_engine
+if /I "%TARGET%"=="bench" goto build_bench
+if /I "%TARGET%"=="tests" goto build_tests
+
 echo Building Videoeditor in %BUILD_TYPE% mode...
 echo Current directory: %CD%
 
@@ -61,7 +69,10 @@ cl.exe /Zi /EHsc /nologo %RUNTIME_FLAG% /std:c++17 /arch:AVX2 ^
     /D "UNICODE" ^
     /Fe:x64\%BUILD_TYPE%\Videoeditor.exe ^
     Videoeditor\Videoeditor.cpp ^
+    Videoeditor\VideoeditorApi.cpp ^
     Videoeditor\FileSelector.cpp ^
+    Videoeditor\RenderServer.cpp ^
+    Videoeditor\nanosvg_impl.cpp ^
     /I"%OPENCV_DIR%\build\include" ^
     /I"%OPENCV_DIR%\build\include\opencv2" ^
     /I".\include" ^
@@ -73,6 +84,7 @@ cl.exe /Zi /EHsc /nologo %RUNTIME_FLAG% /std:c++17 /arch:AVX2 ^
     opencv_world%OPENCV_VERSION%%OPENCV_SUFFIX%.lib ^
     ole32.lib ^
     oleaut32.lib ^
+    ws2_32.lib ^
     ucrt%OPENCV_SUFFIX%.lib ^
     vcruntime%OPENCV_SUFFIX%.lib ^
     msvcrt%OPENCV_SUFFIX%.lib
@@ -102,6 +114,86 @@ if %ERRORLEVEL% EQU 0 (
 ) else (
     echo Build failed with error %ERRORLEVEL%
 )
+goto done
+
+:build_engine
+:: videoeditor_engine.dll: the C API (VideoeditorApi.h) for loading in-process via Dart FFI
+echo Building videoeditor_engine.dll in %BUILD_TYPE% mode...
+cl.exe /Zi /EHsc /nologo /LD %RUNTIME_FLAG% /std:c++17 /arch:AVX2 ^
+    %DEBUG_FLAG% ^
+    /D "VIDEOEDITOR_SHARED" ^
+    /Fe:x64\%BUILD_TYPE%\videoeditor_engine.dll ^
+    Videoeditor\VideoeditorApi.cpp ^
+    Videoeditor\nanosvg_impl.cpp ^
+    /I"%OPENCV_DIR%\build\include" ^
+    /I".\include" ^
+    /link ^
+    /DEBUG:FULL ^
+    /MACHINE:X64 ^
+    /LIBPATH:"%OPENCV_DIR%\build\x64\vc16\lib" ^
+    opencv_world%OPENCV_VERSION%%OPENCV_SUFFIX%.lib
+
+if %ERRORLEVEL% EQU 0 (
+    copy /Y "%OPENCV_DIR%\build\x64\vc16\bin\opencv_world%OPENCV_VERSION%%OPENCV_SUFFIX%.dll" "x64\%BUILD_TYPE%\"
+    copy /Y "%OPENCV_DIR%\build\x64\vc16\bin\opencv_videoio_ffmpeg%OPENCV_VERSION%_64.dll" "x64\%BUILD_TYPE%\"
+    set FLUTTER_BUILD_DIR=..\build\windows\runner\%BUILD_TYPE%
+    if exist "!FLUTTER_BUILD_DIR!" copy /Y "x64\%BUILD_TYPE%\*.dll" "!FLUTTER_BUILD_DIR!\"
+) else (
+    echo Build failed with error %ERRORLEVEL%
+)
+goto done
+
+:build_bench
+:: Benchmarks: synthetic recordings, per-stage microbenchmarks, end-to-end fps
+echo Building Benchmark in %BUILD_TYPE% mode...
+cl.exe /Zi /EHsc /nologo %RUNTIME_FLAG% /std:c++17 /arch:AVX2 ^
+    %DEBUG_FLAG% ^
+    /D "_CONSOLE" ^
+    /Fe:x64\%BUILD_TYPE%\Benchmark.exe ^
+    bench\Benchmark.cpp ^
+    Videoeditor\nanosvg_impl.cpp ^
+    /I"%OPENCV_DIR%\build\include" ^
+    /I".\include" ^
+    /link ^
+    /MACHINE:X64 ^
+    /SUBSYSTEM:CONSOLE ^
+    /LIBPATH:"%OPENCV_DIR%\build\x64\vc16\lib" ^
+    opencv_world%OPENCV_VERSION%%OPENCV_SUFFIX%.lib
+
+if %ERRORLEVEL% EQU 0 (
+    copy /Y "%OPENCV_DIR%\build\x64\vc16\bin\opencv_world%OPENCV_VERSION%%OPENCV_SUFFIX%.dll" "x64\%BUILD_TYPE%\"
+    copy /Y "%OPENCV_DIR%\build\x64\vc16\bin\opencv_videoio_ffmpeg%OPENCV_VERSION%_64.dll" "x64\%BUILD_TYPE%\"
+    echo Run: x64\%BUILD_TYPE%\Benchmark.exe all --cursors Videoeditor\cursors --csv benchmark_results.csv --label ^<commit^>
+) else (
+    echo Build failed with error %ERRORLEVEL%
+)
+goto done
+
+:build_tests
+:: Golden-frame regression test: export path vs. reference path and stored PNGs
+echo Building GoldenFrames in %BUILD_TYPE% mode...
+cl.exe /Zi /EHsc /nologo %RUNTIME_FLAG% /std:c++17 /arch:AVX2 ^
+    %DEBUG_FLAG% ^
+    /D "_CONSOLE" ^
+    /Fe:x64\%BUILD_TYPE%\GoldenFrames.exe ^
+    tests\GoldenFrames.cpp ^
+    Videoeditor\nanosvg_impl.cpp ^
+    /I"%OPENCV_DIR%\build\include" ^
+    /I".\include" ^
+    /link ^
+    /MACHINE:X64 ^
+    /SUBSYSTEM:CONSOLE ^
+    /LIBPATH:"%OPENCV_DIR%\build\x64\vc16\lib" ^
+    opencv_world%OPENCV_VERSION%%OPENCV_SUFFIX%.lib
+
+if %ERRORLEVEL% EQU 0 (
+    copy /Y "%OPENCV_DIR%\build\x64\vc16\bin\opencv_world%OPENCV_VERSION%%OPENCV_SUFFIX%.dll" "x64\%BUILD_TYPE%\"
+    x64\%BUILD_TYPE%\GoldenFrames.exe --cursors Videoeditor\cursors --golden tests\golden --out x64\%BUILD_TYPE%\golden_diff
+    if !ERRORLEVEL! NEQ 0 echo Golden-frame test FAILED
+) else (
+    echo Build failed with error %ERRORLEVEL%
+)
 
+:done
 endlocal
 pause 
\ No newline at end of file
@@ -0,0 +1,346 @@
+// GoldenFrames.cpp : Guards the optimized render path against visual drift.
+//
+//   GoldenFrames.exe [--cursors <dir>] [--golden <dir>] [--update] [--allow-missing] [--out <dir>]
+//
+// Renders the synthetic recording (bench/SyntheticRecording.h) through the
+// export path (FrameCompositor + ZoomProcessor, incremental, frame after
+// frame) and, for selected frames, through a straightforward full-frame
+// reference path. Each selected frame must match
+//   1. the reference render, within REFERENCE thresholds, and
+//   2. its stored golden PNG (tests/golden/frame_NNNN.png), within GOLDEN thresholds.
+// --update rewrites the golden PNGs from the current export path instead of
+// comparing against them; do that only for intended visual changes. A missing
+// golden fails the run unless --allow-missing is given, and a golden of a
+// different size always fails. --out writes diff images for failures.
+// Exit code is 0 only when every comparison passes.
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../bench/SyntheticRecording.h"
+#include "../Videoeditor/CursorData.h"
+#include "../Videoeditor/CursorOverlay.h"
+#include "../Videoeditor/FrameCompositor.h"
+#include "../Videoeditor/FrameLayout.h"
+#include "../Videoeditor/ZoomConfigLoader.h"
+#include "../Videoeditor/ZoomPlan.h"
+#include "../Videoeditor/ZoomProcessor.h"
+
+struct Thresholds {
+    double minPsnr;    // dB
+    double minSsim;
+    double maxAbs;     // Largest per-channel difference allowed anywhere
+};
+
+// The reference resamples with cv::resize while the export path warps
+// regions, so a little interpolation noise is expected between them
+static const Thresholds REFERENCE = {45.0, 0.995, 24.0};
+// Goldens come from the export path itself and PNG is lossless, so on the
+// machine that wrote them the match is exact. The slack is for other build
+// machines: OpenCV's SIMD and scalar warpAffine/resize kernels round bilinear
+// weights differently, and nanosvg's anti-aliased edges move with the
+// compiler's floating-point contraction, which shifts a few edge pixels by a
+// handful of levels. Anything systematic (a misplaced cursor, a wrong zoom
+// rectangle, a colour shift) still fails on PSNR and SSIM.
+static const Thresholds GOLDEN = {50.0, 0.998, 8.0};
+
+struct Metrics {
+    double psnr = 0;
+    double ssim = 0;
+    double maxAbs = 0;
+
+    bool passes(const Thresholds& t) const {
+        return psnr >= t.minPsnr && ssim >= t.minSsim && maxAbs <= t.maxAbs;
+    }
+};
+
+// Mean SSIM over the BGR channels (Gaussian 11x11, sigma 1.5, as in Wang et al.)
+static double ssim(const cv::Mat& a, const cv::Mat& b) {
+    const double C1 = 6.5025, C2 = 58.5225;
+    cv::Mat x, y;
+    a.convertTo(x, CV_32F);
+    b.convertTo(y, CV_32F);
+
+    cv::Mat xx = x.mul(x), yy = y.mul(y), xy = x.mul(y);
+    cv::Mat muX, muY, sigmaXX, sigmaYY, sigmaXY;
+    cv::GaussianBlur(x, muX, cv::Size(11, 11), 1.5);
+    cv::GaussianBlur(y, muY, cv::Size(11, 11), 1.5);
+    cv::GaussianBlur(xx, sigmaXX, cv::Size(11, 11), 1.5);
+    cv::GaussianBlur(yy, sigmaYY, cv::Size(11, 11), 1.5);
+    cv::GaussianBlur(xy, sigmaXY, cv::Size(11, 11), 1.5);
+
+    cv::Mat muXX = muX.mul(muX), muYY = muY.mul(muY), muXY = muX.mul(muY);
+    sigmaXX -= muXX;
+    sigmaYY -= muYY;
+    sigmaXY -= muXY;
+
+    cv::Mat numerator = (2 * muXY + C1).mul(2 * sigmaXY + C2);
+    cv::Mat denominator = (muXX + muYY + C1).mul(sigmaXX + sigmaYY + C2);
+    cv::Mat map;
+    cv::divide(numerator, denominator, map);
+    cv::Scalar mean = cv::mean(map);
+    return (mean[0] + mean[1] + mean[2]) / 3.0;
+}
+
+static Metrics compare(const cv::Mat& a, const cv::Mat& b) {
+    Metrics m;
+    m.maxAbs = cv::norm(a, b, cv::NORM_INF);
+    m.psnr = m.maxAbs == 0 ? 99.0 : cv::PSNR(a, b);
+    m.ssim = ssim(a, b);
+    return m;
+}
+
+// Full-frame render with no caching or region tracking: a full-canvas
+// background with a full-resolution shadow blur, one cv::resize of the video,
+// rounded corners by a coverage blend over the whole card, cursor, then zoom by
+// resizing the whole frame and cropping. This is the behaviour the export path
+// optimizes.
+class ReferenceRenderer {
+private:
+    BackgroundSettings background;
+    FrameLayout layout;
+    const ZoomPlan& plan;
+
+    // Per-pixel coverage of the rounded card:
+    // clamp(r - distance from the pixel centre to the corner arc + 0.5, 0, 1)
+    cv::Mat cardCoverage(const cv::Size& size) const {
+        cv::Mat coverage(size, CV_32FC1);
+        double r = (std::min)(layout.cornerRadius, (std::min)(size.width, size.height) / 2.0);
+        for (int y = 0; y < size.height; ++y) {
+            double cy = y + 0.5;
+            double dy = (std::max)({0.0, r - cy, cy - (size.height - r)});
+            for (int x = 0; x < size.width; ++x) {
+                double cx = x + 0.5;
+                double dx = (std::max)({0.0, r - cx, cx - (size.width - r)});
+                coverage.at<float>(y, x) = static_cast<float>(
+                    (std::min)(1.0, (std::max)(0.0, r - std::sqrt(dx * dx + dy * dy) + 0.5)));
+            }
+        }
+        return coverage;
+    }
+
+    static cv::Scalar toScalar(uint32_t argb) {
+        return cv::Scalar(argb & 0xFF, (argb >> 8) & 0xFF, (argb >> 16) & 0xFF);
+    }
+
+    // dst = dst + (value - dst) * alpha, with a single-channel alpha
+    static void blend(cv::Mat& dst, const cv::Mat& value, const cv::Mat& alpha) {
+        cv::Mat alpha3;
+        cv::merge(std::vector<cv::Mat>{alpha, alpha, alpha}, alpha3);
+        dst += (value - dst).mul(alpha3);
+    }
+
+    // Solid colour plus shadow; the synthetic configuration uses no other background type
+    cv::Mat renderBackground() const {
+        cv::Mat canvas(layout.canvasSize, CV_32FC3, toScalar(background.color));
+        const ShadowSettings& shadow = background.shadow;
+        if (!shadow.enabled || shadow.opacity <= 0) {
+            return canvas;
+        }
+        cv::Mat alpha(layout.canvasSize, CV_32FC1, cv::Scalar(0));
+        cv::Rect card = layout.videoRect + cv::Point(static_cast<int>(std::lround(shadow.offsetX)),
+                                                     static_cast<int>(std::lround(shadow.offsetY)));
+        cv::Rect visible = card & cv::Rect(cv::Point(0, 0), layout.canvasSize);
+        cardCoverage(card.size())(visible - card.tl()).copyTo(alpha(visible));
+        cv::GaussianBlur(alpha, alpha, cv::Size(0, 0), shadow.blur / 2.0);
+        alpha *= shadow.opacity;
+        blend(canvas, cv::Mat(layout.canvasSize, CV_32FC3, toScalar(shadow.color)), alpha);
+        return canvas;
+    }
+
+public:
+    ReferenceRenderer(const BackgroundSettings& settings, const FrameLayout& frameLayout, const ZoomPlan& zoomPlan)
+        : background(settings), layout(frameLayout), plan(zoomPlan) {}
+
+    cv::Mat render(const cv::Mat& source, CursorOverlay& cursor, const CursorPosition& pos, int frameIndex) const {
+        // Geometry comes from the layout; only the pixel work is reimplemented
+        cv::Rect videoRect = layout.videoRect;
+        cv::Size size = layout.canvasSize;
+
+        cv::Mat canvasF = renderBackground();
+        cv::Mat scaled, scaledF;
+        cv::resize(source, scaled, videoRect.size(), 0, 0, cv::INTER_LANCZOS4);
+        scaled.convertTo(scaledF, CV_32FC3);
+        cv::Mat card = canvasF(videoRect);
+        blend(card, scaledF, cardCoverage(videoRect.size()));
+        cv::Mat canvas;
+        canvasF.convertTo(canvas, CV_8UC3);
+
+        double cursorX = pos.x * videoRect.width + videoRect.x;
+        double cursorY = pos.y * videoRect.height + videoRect.y;
+        cursor.overlay(canvas, cursorX, cursorY, pos.cursorType);
+
+        ZoomState state = plan.at(frameIndex);
+        int zoomedWidth = static_cast<int>(size.width * state.scale);
+        int zoomedHeight = static_cast<int>(size.height * state.scale);
+        int x = std::clamp(static_cast<int>((zoomedWidth - size.width) * state.targetX), 0, zoomedWidth - size.width);
+        int y = std::clamp(static_cast<int>((zoomedHeight - size.height) * state.targetY), 0, zoomedHeight - size.height);
+        if (zoomedWidth == size.width && zoomedHeight == size.height) {
+            return canvas;
+        }
+        cv::Mat zoomed;
+        cv::resize(canvas, zoomed, cv::Size(zoomedWidth, zoomedHeight), 0, 0, cv::INTER_LINEAR);
+        return zoomed(cv::Rect(x, y, size.width, size.height)).clone();
+    }
+};
+
+struct GoldenArgs {
+    std::string cursorDir = "Videoeditor/cursors";
+    std::string goldenDir = "tests/golden";
+    std::string outDir;
+    bool update = false;
+    bool allowMissing = false;   // Report missing goldens without failing
+};
+
+static void printMetrics(const std::string& label, const Metrics& m, bool ok) {
+    std::cout << "  " << std::left << std::setw(10) << label << std::right << std::fixed
+              << std::setprecision(2) << "PSNR " << std::setw(6) << m.psnr << " dB  "
+              << std::setprecision(4) << "SSIM " << m.ssim << "  "
+              << std::setprecision(0) << "max " << std::setw(3) << m.maxAbs
+              << (ok ? "  ok" : "  FAIL") << std::endl;
+}
+
+static void writeDiff(const GoldenArgs& args, const std::string& name, const cv::Mat& a, const cv::Mat& b) {
+    if (args.outDir.empty()) return;
+    std::filesystem::create_directories(args.outDir);
+    cv::Mat diff;
+    cv::absdiff(a, b, diff);
+    diff *= 8;  // Make small drift visible
+    cv::imwrite((std::filesystem::path(args.outDir) / (name + "_actual.png")).string(), a);
+    cv::imwrite((std::filesystem::path(args.outDir) / (name + "_diff.png")).string(), diff);
+}
+
+int main(int argc, char* argv[]) {
+    GoldenArgs args;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--update") args.update = true;
+        else if (arg == "--allow-missing") args.allowMissing = true;
+        else if (arg == "--cursors" && i + 1 < argc) args.cursorDir = argv[++i];
+        else if (arg == "--golden" && i + 1 < argc) args.goldenDir = argv[++i];
+        else if (arg == "--out" && i + 1 < argc) args.outDir = argv[++i];
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 2;
+        }
+    }
+
+    // Small enough to run in seconds, long enough for all phases and a zoom transition
+    SyntheticRecording::Options options;
+    options.width = 1280;
+    options.height = 720;
+    options.seconds = 10.0;
+    SyntheticRecording recording(options);
+    const std::vector<int> selected = {0, 15, 45, 89, 95, 130, 175, 200, 240, 299};
+
+    ZoomConfig config;
+    ZoomConfigLoader::parse(recording.zoomJson(), config);
+
+    std::filesystem::path cursorPath = std::filesystem::temp_directory_path() / "videoeditor_golden_cursor.json";
+    {
+        std::ofstream file(cursorPath);
+        file << recording.cursorJson().dump();
+    }
+    CursorData cursorData;
+    cursorData.setVideoFPS(options.fps);
+    if (!cursorData.loadFromJson(cursorPath.string())) {
+        return 2;
+    }
+
+    ZoomPlan plan;
+    plan.build(config, &cursorData, recording.frameCount(), recording.getOptions().fps);
+
+    // Library logging goes to stderr so the report stays readable
+    std::streambuf* stdoutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+    CursorOverlay cursor;
+    bool cursorsLoaded = cursor.loadCursors(args.cursorDir);
+    std::cout.rdbuf(stdoutBuffer);
+    if (!cursorsLoaded) {
+        std::cerr << "Error: cursor sprites not found in " << args.cursorDir << std::endl;
+        return 2;
+    }
+    cursor.setSettings(config.cursor);
+
+    FrameCompositor compositor;
+    FrameLayout layout = FrameLayout::compute(cv::Size(options.width, options.height),
+                                              config.background, 0);
+    compositor.setSettings(config.background, layout);
+    ZoomProcessor processor;
+    processor.setPlan(&plan);
+    ReferenceRenderer reference(config.background, layout, plan);
+
+    int failures = 0;
+    int missingGoldens = 0;
+    cv::Mat source;
+    cv::Mat output;
+    for (int frameIndex = 0; frameIndex <= selected.back(); frameIndex++) {
+        recording.renderFrame(frameIndex, source);
+        CursorPosition pos = cursorData.getPositionAtFrame(frameIndex);
+        const cv::Mat& composited = compositor.compose(source, cursor, pos);
+        processor.processFrame(composited, output, frameIndex, &compositor.getDirtyRects());
+
+        if (std::find(selected.begin(), selected.end(), frameIndex) == selected.end()) {
+            continue;
+        }
+
+        std::ostringstream name;
+        name << "frame_" << std::setw(4) << std::setfill('0') << frameIndex;
+        std::cout << name.str() << std::endl;
+
+        cv::Mat expected = reference.render(source, cursor, pos, frameIndex);
+        Metrics vsReference = compare(output, expected);
+        bool referenceOk = vsReference.passes(REFERENCE);
+        printMetrics("reference", vsReference, referenceOk);
+        if (!referenceOk) {
+            failures++;
+            writeDiff(args, name.str() + "_reference", output, expected);
+        }
+
+        std::filesystem::path goldenPath = std::filesystem::path(args.goldenDir) / (name.str() + ".png");
+        if (args.update) {
+            std::filesystem::create_directories(args.goldenDir);
+            cv::imwrite(goldenPath.string(), output, {cv::IMWRITE_PNG_COMPRESSION, 9});
+            std::cout << "  golden    updated" << std::endl;
+            continue;
+        }
+        cv::Mat golden = cv::imread(goldenPath.string(), cv::IMREAD_COLOR);
+        if (golden.empty()) {
+            std::cout << "  golden    missing (" << goldenPath.string() << ")" << std::endl;
+            missingGoldens++;
+            continue;
+        }
+        if (golden.size() != output.size()) {
+            std::cout << "  golden    " << golden.cols << "x" << golden.rows << ", output "
+                      << output.cols << "x" << output.rows << "  FAIL" << std::endl;
+            failures++;
+            continue;
+        }
+        Metrics vsGolden = compare(output, golden);
+        bool goldenOk = vsGolden.passes(GOLDEN);
+        printMetrics("golden", vsGolden, goldenOk);
+        if (!goldenOk) {
+            failures++;
+            writeDiff(args, name.str() + "_golden", output, golden);
+        }
+    }
+
+    std::error_code ignored;
+    std::filesystem::remove(cursorPath, ignored);
+
+    std::cout << "\n" << failures << " failed comparison(s)";
+    if (missingGoldens > 0) {
+        std::cout << ", " << missingGoldens << " golden frame(s) missing (run with --update)";
+    }
+    std::cout << std::endl;
+    if (missingGoldens > 0 && !args.allowMissing) {
+        return 1;
+    }
+    return failures == 0 ? 0 : 1;
+}
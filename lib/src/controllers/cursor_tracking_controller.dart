@@ -77,6 +77,7 @@ class CursorTrackingController extends StateNotifier<CursorTrackingState> {
             y: cursorInfo.position.dy,
             timestamp: timestamp,
             cursorType: cursorInfo.cursorType,
+            buttons: cursorInfo.buttons,
           ),
         ],
       );
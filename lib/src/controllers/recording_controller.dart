@@ -326,6 +326,7 @@ class RecordingController extends StateNotifier<RecordingState> {
             'y': pos.y,
             'timestamp': pos.timestamp,
             'cursorType': pos.cursorType,
+            'buttons': pos.buttons,
           }).toList(),
         };
         
@@ -3,12 +3,14 @@ class CursorPosition {
   final double y;
   final int timestamp;
   final int cursorType; // Store the Windows cursor type ID
+  final int buttons; // Mouse buttons held: 1 left, 2 right, 4 middle
 
   const CursorPosition({
     required this.x,
     required this.y,
     required this.timestamp,
     required this.cursorType,
+    this.buttons = 0,
   });
 
   factory CursorPosition.fromJson(Map<String, dynamic> json) {
@@ -17,6 +19,7 @@ class CursorPosition {
       y: json['y'] as double,
       timestamp: json['timestamp'] as int,
       cursorType: json['cursorType'] as int,
+      buttons: json['buttons'] as int? ?? 0,
     );
   }
 
@@ -25,5 +28,6 @@ class CursorPosition {
     'y': y,
     'timestamp': timestamp,
     'cursorType': cursorType,
+    'buttons': buttons,
   };
 } 
\ No newline at end of file
@@ -77,6 +77,7 @@ class RecordingNotifier extends StateNotifier<RecordingState> {
         y: cursorInfo.position.dy,
         timestamp: timestamp,
         cursorType: cursorInfo.cursorType,
+        buttons: cursorInfo.buttons,
       ));
     }
   }
@@ -242,6 +242,7 @@ class _VideoEditorScreenState extends ConsumerState<VideoEditorScreen> with Tick
           y: interpolatedY,
           timestamp: currentTimeMs,
           cursorType: currentPos.cursorType,
+          buttons: currentPos.buttons,
         );
 
         // Track cursor events
@@ -8,8 +8,9 @@ class CursorInfo {
   final Offset position;
   final int cursorType;
   final bool isInSelectedDisplay;
+  final int buttons; // Mouse buttons held: 1 left, 2 right, 4 middle
 
-  CursorInfo(this.position, this.cursorType, this.isInSelectedDisplay);
+  CursorInfo(this.position, this.cursorType, this.isInSelectedDisplay, [this.buttons = 0]);
 }
 
 class CursorTracker {
@@ -64,6 +65,7 @@ class CursorTracker {
             Offset(relativeX, relativeY),
             mapCursorType(cursorHandle),
             true,
+            getButtons(),
           );
         }
         return null;
@@ -76,6 +78,16 @@ class CursorTracker {
     }
   }
 
+  // Mouse buttons currently held, as the bit mask the exporter reads
+  // from the cursor data (1 left, 2 right, 4 middle)
+  static int getButtons() {
+    int buttons = 0;
+    if (GetAsyncKeyState(VK_LBUTTON) & 0x8000 != 0) buttons |= 1;
+    if (GetAsyncKeyState(VK_RBUTTON) & 0x8000 != 0) buttons |= 2;
+    if (GetAsyncKeyState(VK_MBUTTON) & 0x8000 != 0) buttons |= 4;
+    return buttons;
+  }
+
   // Map Windows cursor handles to our fixed cursor types
   static int mapCursorType(int windowsCursorHandle) {
     // Get standard cursor handles for comparison